@@ -1,47 +1,93 @@
-#pragma once
-
-
-///
-/// Interface for a runtime of the Boggle game
-///
-
-// ----------------------------------------------------------------------------
-
-
-#include <cstdint>
-#include <vector>
-
-
-// ----------------------------------------------------------------------------
-
-
-namespace boggle_game
-{
-  struct SBoggleResults
-  {
-    std::vector<const char*> words;
-    uint32_t score = 0;
-  };
-}
-
-
-// ----------------------------------------------------------------------------
-
-
-namespace boggle_game
-{
-  class IRuntime
-  {
-  public:
-
-    IRuntime() {}
-    virtual ~IRuntime() {}
-
-    virtual void LoadDictionary(const char* path) = 0;
-
-    virtual SBoggleResults FindWords(const char* pBoardData, uint32_t width, uint32_t height) = 0;
-
-  protected:
-    static const uint8_t C_MAX_WORD_LENGTH = 15;
-  };
-}
+#pragma once
+
+
+///
+/// Interface for a runtime of the Boggle game
+///
+
+// ----------------------------------------------------------------------------
+
+
+#include <cstdint>
+#include <vector>
+
+
+// ----------------------------------------------------------------------------
+
+
+namespace boggle_game
+{
+  struct SBoggleResults
+  {
+    std::vector<const char*> words;
+    uint32_t score = 0;
+  };
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+namespace boggle_game
+{
+  class IRuntime
+  {
+  public:
+
+    IRuntime() {}
+    virtual ~IRuntime() {}
+
+    virtual void LoadDictionary(const char* path) = 0;
+
+    virtual SBoggleResults FindWords(const char* pBoardData, uint32_t width, uint32_t height) = 0;
+
+    /// Solve <count> boards of <width> x <height> letters, with one result per
+    /// board in the same order. Techniques that can't do any better than one
+    /// board after the other just call FindWords.
+    virtual std::vector<SBoggleResults> FindWordsBatch(const char* const* ppBoardData, uint32_t count, uint32_t width, uint32_t height);
+
+    /// Only the score of the board. Techniques that can skip building the
+    /// word list do so.
+    virtual uint32_t FindScore(const char* pBoardData, uint32_t width, uint32_t height);
+
+    /// Store the loaded dictionary in a binary format, which loads much faster
+    /// than the text file. Not every technique supports this, in which case
+    /// false is returned.
+    virtual bool SaveCompiledDictionary(const char* /*path*/) const { return false; }
+    virtual bool LoadCompiledDictionary(const char* /*path*/) { return false; }
+
+  public:
+    /// According to the rules then a valid word must be 3 or more letters
+    static const uint8_t C_MIN_WORD_LENGTH = 3;
+
+    /// Our own limitation to optimize a lookup table
+    static const uint8_t C_MAX_WORD_LENGTH = 15;
+  };
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+inline std::vector<boggle_game::SBoggleResults> boggle_game::IRuntime::FindWordsBatch(
+  const char* const* ppBoardData,
+  uint32_t count,
+  uint32_t width,
+  uint32_t height)
+{
+  std::vector<SBoggleResults> results;
+  results.reserve(count);
+
+  for (uint32_t i = 0; i < count; i++)
+  {
+    results.push_back(FindWords(ppBoardData[i], width, height));
+  }
+
+  return results;
+}
+
+
+inline uint32_t boggle_game::IRuntime::FindScore(const char* pBoardData, uint32_t width, uint32_t height)
+{
+  return FindWords(pBoardData, width, height).score;
+}
@@ -1,209 +1,1256 @@
-#include "../common/utils.hpp"
-
-#include <include/iruntime.hpp>
-#include <include/runtimefactory.hpp>
-
-#include <cassert>
-#include <chrono>
-#include <cstdint>
-#include <fstream>
-#include <iostream>
-#include <thread>
-#include <set>
-#include <string>
-#include <vector>
-
-
-// ----------------------------------------------------------------------------
-
-
-namespace boggle_game_test
-{
-  void GenerateBoard(const uint32_t width, const uint32_t height, std::vector<char>& out)
-  {
-    out.resize(width * height);
-
-    for (auto& c : out)
-    {
-      c = (rand() % ('z' - 'a')) + 'a';
-    }
-  }
-
-
-  void LoadBoard(const std::string& rootFolder, uint32_t& widthOut, uint32_t& heightOut, std::vector<char>& boardArrayOut)
-  {
-    ///
-    /// Load a potential predefined board
-    ///
-    const std::string boardFilePath = rootFolder + "/board.txt";
-    std::ifstream boardFileStream(boardFilePath, std::ifstream::binary);
-    if (boardFileStream)
-    {
-      std::string currentLine;
-      while (std::getline(boardFileStream, currentLine))
-      {
-        widthOut = 0;
-        for (const char c : currentLine)
-        {
-          if (isalpha(c))
-          {
-            boardArrayOut.push_back(c);
-            widthOut++;
-          }
-        }
-
-        heightOut++;
-      }
-    }
-    ///
-    /// if there's no file named "board.txt", then generate the board instead ...
-    ///
-    else
-    {
-      std::cout << "Couldn't open board file: '"
-        << boardFilePath
-        << "'. Will generate a random one instead, and write it to disk." << std::endl;
-
-      widthOut =  10000;
-      heightOut = 10000;
-      GenerateBoard(widthOut, heightOut, boardArrayOut);
-
-      ///
-      /// Dump the new board to disk to ensure we have consistent test data
-      ///
-      std::ofstream boardFileStreamOut(rootFolder + "/board.txt", std::ofstream::binary);
-      if (boardFileStreamOut)
-      {
-        uint32_t currentX = 0;
-        uint32_t currentY = 0;
-        for (const char c : boardArrayOut)
-        {
-          boardFileStreamOut << c;
-
-          currentX++;
-          if (currentX == widthOut)
-          {
-            currentX = 0;
-            currentY++;
-
-            boardFileStreamOut << '\n';
-          }
-        }
-
-        assert(currentX == 0);
-        assert(currentY == heightOut);
-      }
-    }
-  }
-
-
-  void CheckResultAgainstExpectedFile(const std::string& rootFolder, const boggle_game::SBoggleResults& result)
-  {
-    const std::string filePath = rootFolder + "/expected_word_list.txt";
-    std::ifstream fileStream(filePath, std::ifstream::binary);
-    if (!fileStream)
-    {
-      std::cout << "Couldn't open expected result set: '"
-        << filePath
-        << "'. Will skip test verification and dump the found words to the expected file." << std::endl;
-
-
-      std::ofstream expectedWordsFileStreamOut(rootFolder + "/expected_word_list.txt", std::ofstream::binary);
-      if (expectedWordsFileStreamOut)
-      {
-        for (size_t i = 0; i < result.words.size(); i++)
-        {
-          expectedWordsFileStreamOut << result.words[i] << std::endl;
-        }
-      }
-
-      return;
-    }
-
-
-    std::set<std::string> expectedWords;
-
-    std::string currentWord;
-    while (std::getline(fileStream, currentWord))
-    {
-      expectedWords.insert(currentWord);
-    }
-
-    ROTA_ASSERT(result.words.size() == expectedWords.size()  &&  "Expected word count failed");
-
-    for (uint32_t i = 0; i < result.words.size(); i++)
-    {
-      const char* pCurrentWord = result.words[i];
-
-      const bool foundWord = expectedWords.find(pCurrentWord) != expectedWords.cend();
-
-      ROTA_ASSERT(foundWord  &&  "Didn't find word in the result set.");
-    }
-
-    std::cout << "Test passed!" << std::endl;
-  }
-
-
-  void RunTestFromDir(const std::string& testFolder)
-  {
-    std::cout << "Will execute test in: " << testFolder << std::endl;
-
-    const auto timeStart = std::chrono::steady_clock::now();
-
-    const std::string rootFolder
-      = "bin/boggle_gamelib.test/testdata/" + testFolder;
-
-    auto pRuntime = boggle_game::CreateRuntimeSolver(boggle_game::EBoggleSolver::TrieThreaded);
-
-    ///
-    /// Use the exposed function <LoadDictionary> to load our dictionary file ...
-    ///
-    pRuntime->LoadDictionary( std::string(rootFolder + "/dictionary.txt").c_str() );
-
-    const auto timeAfterLoadingDictionary = std::chrono::steady_clock::now();
-
-    uint32_t width = 0;
-    uint32_t height = 0;
-    std::vector<char> boardArray;
-    LoadBoard(rootFolder, width, height, boardArray);
-
-    const auto timeAfterLoadingBoard = std::chrono::steady_clock::now();
-
-    const auto result = pRuntime->FindWords(boardArray.data(), width, height);
-
-    const auto timeEnd = std::chrono::steady_clock::now();
-
-    std::cout
-      << "Found " << result.words.size() << " words for a score of " << result.score << std::endl
-      << "  Total time: " << std::chrono::duration_cast<std::chrono::milliseconds>(timeEnd - timeStart).count() << " ms" << std::endl
-      << "  LoadDictionary : " << std::chrono::duration_cast<std::chrono::milliseconds>(timeAfterLoadingDictionary - timeStart).count() << " ms" << std::endl
-      << "  LoadingBoard : " << std::chrono::duration_cast<std::chrono::milliseconds>(timeAfterLoadingBoard - timeAfterLoadingDictionary).count() << " ms" << std::endl
-      << "  FindWords : " << std::chrono::duration_cast<std::chrono::milliseconds>(timeEnd - timeAfterLoadingBoard).count() << " ms" << std::endl
-      ;
-
-    CheckResultAgainstExpectedFile(rootFolder, result);
-
-    std::this_thread::sleep_for( std::chrono::seconds(2) );
-  }
-}
-
-
-// ----------------------------------------------------------------------------
-
-
-int main()
-{
-  /// Regression tests
-  boggle_game_test::RunTestFromDir("regression_qu1");
-  boggle_game_test::RunTestFromDir("regression_qu2");
-  boggle_game_test::RunTestFromDir("regression_ensure-non-duplicates");
-
-  /// Performance test
-  boggle_game_test::RunTestFromDir("performance_huge");
-  boggle_game_test::RunTestFromDir("performance_monster");
-  boggle_game_test::RunTestFromDir("performance_titan");
-  boggle_game_test::RunTestFromDir("performance_titans-creator");
-
-
-  return 0;
-}
+#include "../common/utils.hpp"
+#include "../common/containers/trie-pool-optimized.hpp"
+#include "../boggle_gamelib/band-solver.hpp"
+#include "../boggle_gamelib/board-optimizer.hpp"
+#include "../boggle_gamelib/runtime_bitboard.hpp"
+#include "../boggle_gamelib/runtime_fixed-board.hpp"
+#include "../boggle_gamelib/runtime_incremental.hpp"
+#include "../boggle_gamelib/runtime_trie-parallel.hpp"
+#include "../boggle_gamelib/runtime_trie-pool-optimized.hpp"
+#include "../boggle_gamelib/runtime_trie-threaded.hpp"
+
+#include <include/iruntime.hpp>
+#include <include/runtimefactory.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdio>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <set>
+#include <string>
+#include <vector>
+
+
+// ----------------------------------------------------------------------------
+
+
+namespace boggle_game_test
+{
+  void GenerateBoard(const uint32_t width, const uint32_t height, std::vector<char>& out)
+  {
+    out.resize(size_t(width) * height);
+
+    for (auto& c : out)
+    {
+      c = (rand() % ('z' - 'a')) + 'a';
+    }
+  }
+
+
+  void LoadBoard(const std::string& rootFolder, uint32_t& widthOut, uint32_t& heightOut, std::vector<char>& boardArrayOut)
+  {
+    ///
+    /// Load a potential predefined board
+    ///
+    const std::string boardFilePath = rootFolder + "/board.txt";
+    std::ifstream boardFileStream(boardFilePath, std::ifstream::binary);
+    if (boardFileStream)
+    {
+      std::string currentLine;
+      while (std::getline(boardFileStream, currentLine))
+      {
+        widthOut = 0;
+        for (const char c : currentLine)
+        {
+          if (isalpha(c))
+          {
+            boardArrayOut.push_back(c);
+            widthOut++;
+          }
+        }
+
+        heightOut++;
+      }
+    }
+    ///
+    /// if there's no file named "board.txt", then generate the board instead ...
+    ///
+    else
+    {
+      std::cout << "Couldn't open board file: '"
+        << boardFilePath
+        << "'. Will generate a random one instead, and write it to disk." << std::endl;
+
+      widthOut =  10000;
+      heightOut = 10000;
+      GenerateBoard(widthOut, heightOut, boardArrayOut);
+
+      ///
+      /// Dump the new board to disk to ensure we have consistent test data
+      ///
+      std::ofstream boardFileStreamOut(rootFolder + "/board.txt", std::ofstream::binary);
+      if (boardFileStreamOut)
+      {
+        uint32_t currentX = 0;
+        uint32_t currentY = 0;
+        for (const char c : boardArrayOut)
+        {
+          boardFileStreamOut << c;
+
+          currentX++;
+          if (currentX == widthOut)
+          {
+            currentX = 0;
+            currentY++;
+
+            boardFileStreamOut << '\n';
+          }
+        }
+
+        assert(currentX == 0);
+        assert(currentY == heightOut);
+      }
+    }
+  }
+
+
+  void CheckResultAgainstExpectedFile(const std::string& rootFolder, const boggle_game::SBoggleResults& result)
+  {
+    const std::string filePath = rootFolder + "/expected_word_list.txt";
+    std::ifstream fileStream(filePath, std::ifstream::binary);
+    if (!fileStream)
+    {
+      std::cout << "Couldn't open expected result set: '"
+        << filePath
+        << "'. Will skip test verification and dump the found words to the expected file." << std::endl;
+
+
+      std::ofstream expectedWordsFileStreamOut(rootFolder + "/expected_word_list.txt", std::ofstream::binary);
+      if (expectedWordsFileStreamOut)
+      {
+        for (size_t i = 0; i < result.words.size(); i++)
+        {
+          expectedWordsFileStreamOut << result.words[i] << std::endl;
+        }
+      }
+
+      return;
+    }
+
+
+    std::set<std::string> expectedWords;
+
+    std::string currentWord;
+    while (std::getline(fileStream, currentWord))
+    {
+      expectedWords.insert(currentWord);
+    }
+
+    ROTA_ASSERT(result.words.size() == expectedWords.size()  &&  "Expected word count failed");
+
+    for (uint32_t i = 0; i < result.words.size(); i++)
+    {
+      const char* pCurrentWord = result.words[i];
+
+      const bool foundWord = expectedWords.find(pCurrentWord) != expectedWords.cend();
+
+      ROTA_ASSERT(foundWord  &&  "Didn't find word in the result set.");
+    }
+
+    std::cout << "Test passed!" << std::endl;
+  }
+
+
+  void PrintTriePoolUsage()
+  {
+    const common::SArenaUsage usage = common::CTriePoolOptimized::GetPoolUsage();
+
+    /// Not every solver uses the pool
+    if (!usage.usedCount)
+    {
+      return;
+    }
+
+    std::cout
+      << "  Trie pool: " << usage.usedCount << " of " << usage.capacityCount << " tries used, "
+      << (usage.committedBytes / (1024 * 1024)) << " MB committed" << std::endl;
+  }
+
+
+  void RunTestFromDir(
+    const std::string& testFolder,
+    const uint32_t solveCount = 1,
+    const boggle_game::EBoggleSolver solver = boggle_game::EBoggleSolver::TrieThreaded)
+  {
+    std::cout << "Will execute test in: " << testFolder << std::endl;
+
+    const auto timeStart = std::chrono::steady_clock::now();
+
+    const std::string rootFolder
+      = "bin/boggle_gamelib.test/testdata/" + testFolder;
+
+    auto pRuntime = boggle_game::CreateRuntimeSolver(solver);
+
+    ///
+    /// Use the exposed function <LoadDictionary> to load our dictionary file ...
+    ///
+    pRuntime->LoadDictionary( std::string(rootFolder + "/dictionary.txt").c_str() );
+
+    const auto timeAfterLoadingDictionary = std::chrono::steady_clock::now();
+
+    PrintTriePoolUsage();
+
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<char> boardArray;
+    LoadBoard(rootFolder, width, height, boardArray);
+
+    const auto timeAfterLoadingBoard = std::chrono::steady_clock::now();
+
+    const auto result = pRuntime->FindWords(boardArray.data(), width, height);
+
+    const auto timeEnd = std::chrono::steady_clock::now();
+
+    ///
+    /// The loaded dictionary must be reusable, so solving the same board again
+    /// has to provide the exact same result.
+    ///
+    for (uint32_t i = 1; i < solveCount; i++)
+    {
+      const auto resultAgain = pRuntime->FindWords(boardArray.data(), width, height);
+
+      ROTA_ASSERT(resultAgain.words.size() == result.words.size()  &&  "Dictionary wasn't reusable");
+      ROTA_ASSERT(resultAgain.score == result.score  &&  "Dictionary wasn't reusable");
+    }
+
+    std::cout
+      << "Found " << result.words.size() << " words for a score of " << result.score << std::endl
+      << "  Total time: " << std::chrono::duration_cast<std::chrono::milliseconds>(timeEnd - timeStart).count() << " ms" << std::endl
+      << "  LoadDictionary : " << std::chrono::duration_cast<std::chrono::milliseconds>(timeAfterLoadingDictionary - timeStart).count() << " ms" << std::endl
+      << "  LoadingBoard : " << std::chrono::duration_cast<std::chrono::milliseconds>(timeAfterLoadingBoard - timeAfterLoadingDictionary).count() << " ms" << std::endl
+      << "  FindWords : " << std::chrono::duration_cast<std::chrono::milliseconds>(timeEnd - timeAfterLoadingBoard).count() << " ms" << std::endl
+      ;
+
+    CheckResultAgainstExpectedFile(rootFolder, result);
+
+    std::this_thread::sleep_for( std::chrono::seconds(2) );
+  }
+
+
+  /// Set the parent of <trie> in the compiled dictionary at <path>, and
+  /// update the checksum so the image still looks undamaged. Follows the
+  /// layout described in trie-pool-optimized.cpp.
+  void PatchCompiledDictionaryParent(const std::string& path, const uint32_t trie, const uint32_t parent)
+  {
+    static const size_t C_HEADER_SIZE = 40;
+    static const size_t C_TRIE_SIZE_OFFSET = 12;
+    static const size_t C_TRIE_COUNT_OFFSET = 16;
+    static const size_t C_ROOT_COUNT_OFFSET = 20;
+    static const size_t C_CHECKSUM_OFFSET = 32;
+
+    std::vector<uint8_t> image;
+    {
+      std::ifstream fileStream(path, std::ifstream::binary);
+      image.assign(std::istreambuf_iterator<char>(fileStream), std::istreambuf_iterator<char>());
+    }
+
+    ROTA_ASSERT(image.size() > C_HEADER_SIZE  &&  "Couldn't read the compiled dictionary");
+
+    uint32_t trieSize, trieCount, rootCount;
+    memcpy(&trieSize, &image[C_TRIE_SIZE_OFFSET], sizeof(trieSize));
+    memcpy(&trieCount, &image[C_TRIE_COUNT_OFFSET], sizeof(trieCount));
+    memcpy(&rootCount, &image[C_ROOT_COUNT_OFFSET], sizeof(rootCount));
+
+    const size_t triesOffset = common::AlignUpTo(C_HEADER_SIZE + (rootCount * sizeof(uint32_t)), common::C_CACHE_SIZE);
+    const size_t parentsOffset = triesOffset + (size_t(trieCount) * trieSize);
+
+    memcpy(&image[parentsOffset + (size_t(trie) * sizeof(uint32_t))], &parent, sizeof(parent));
+
+    uint64_t checksum = 0xcbf29ce484222325ull;
+    for (size_t i = C_HEADER_SIZE; i < image.size(); i += sizeof(uint64_t))
+    {
+      uint64_t value;
+      memcpy(&value, &image[i], sizeof(value));
+
+      checksum = (checksum ^ value) * 0x100000001b3ull;
+    }
+
+    memcpy(&image[C_CHECKSUM_OFFSET], &checksum, sizeof(checksum));
+
+    std::ofstream fileStream(path, std::ofstream::binary | std::ofstream::trunc);
+    fileStream.write(reinterpret_cast<const char*>(image.data()), image.size());
+  }
+
+
+  void RunCompiledDictionaryTestFromDir(const std::string& testFolder)
+  {
+    std::cout << "Will execute compiled dictionary test in: " << testFolder << std::endl;
+
+    const std::string rootFolder
+      = "bin/boggle_gamelib.test/testdata/" + testFolder;
+
+    const std::string compiledDictionaryPath = rootFolder + "/dictionary.compiled";
+
+    ///
+    /// Compile the text dictionary ...
+    ///
+    {
+      auto pRuntime = boggle_game::CreateRuntimeSolver(boggle_game::EBoggleSolver::TrieThreaded);
+
+      pRuntime->LoadDictionary( std::string(rootFolder + "/dictionary.txt").c_str() );
+
+      const bool saved = pRuntime->SaveCompiledDictionary(compiledDictionaryPath.c_str());
+
+      ROTA_ASSERT(saved  &&  "Couldn't save the compiled dictionary");
+    }
+
+    ///
+    /// ... and solve the board with a fresh runtime using the compiled one
+    ///
+    const auto timeStart = std::chrono::steady_clock::now();
+
+    auto pRuntime = boggle_game::CreateRuntimeSolver(boggle_game::EBoggleSolver::TrieThreaded);
+
+    const bool loaded = pRuntime->LoadCompiledDictionary(compiledDictionaryPath.c_str());
+
+    ROTA_ASSERT(loaded  &&  "Couldn't load the compiled dictionary");
+
+    const auto timeAfterLoadingDictionary = std::chrono::steady_clock::now();
+
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<char> boardArray;
+    LoadBoard(rootFolder, width, height, boardArray);
+
+    const auto result = pRuntime->FindWords(boardArray.data(), width, height);
+
+    std::cout
+      << "Found " << result.words.size() << " words for a score of " << result.score << std::endl
+      << "  LoadCompiledDictionary : " << std::chrono::duration_cast<std::chrono::milliseconds>(timeAfterLoadingDictionary - timeStart).count() << " ms" << std::endl
+      ;
+
+    CheckResultAgainstExpectedFile(rootFolder, result);
+
+    ///
+    /// An image with a root past the last trie has a valid checksum, as it's
+    /// written just like any other, but must still be turned down
+    ///
+    {
+      const std::string badDictionaryPath = rootFolder + "/dictionary-bad-root.compiled";
+
+      const std::vector<common::CTriePoolOptimized::Index_t> badRoots = { common::CTriePoolOptimized::GetAllocatedTrieCount() };
+      const bool savedBad = common::CTriePoolOptimized::SaveCompiledDictionary(badDictionaryPath.c_str(), badRoots);
+
+      ROTA_ASSERT(savedBad  &&  "Couldn't save the compiled dictionary");
+
+      const bool loadedBad = pRuntime->LoadCompiledDictionary(badDictionaryPath.c_str());
+
+      ROTA_ASSERT(!loadedBad  &&  "A compiled dictionary with a root out of range was loaded");
+
+      std::remove(badDictionaryPath.c_str());
+    }
+
+    ///
+    /// Neither may an image where a root's parent is its own child, so that
+    /// walking up from a found word would never end. The checksum is made to
+    /// match, as that only catches damage.
+    ///
+    {
+      const std::string badDictionaryPath = rootFolder + "/dictionary-bad-parent.compiled";
+
+      /// The failed load above left an empty pool behind
+      const bool reloaded = pRuntime->LoadCompiledDictionary(compiledDictionaryPath.c_str());
+
+      ROTA_ASSERT(reloaded  &&  "Couldn't load the compiled dictionary");
+
+      common::CTriePoolOptimized::Index_t root = 1;
+      while (common::CTriePoolOptimized::GetParent(root) || !common::CTriePoolOptimized::GetPtrFromIndex(root)->GetChildMask())
+      {
+        root++;
+      }
+
+      const uint32_t childMask = common::CTriePoolOptimized::GetPtrFromIndex(root)->GetChildMask();
+      const common::CTriePoolOptimized::Index_t child = common::CTriePoolOptimized::GetPtrFromIndex(root)->GetChild(common::CTriePoolOptimized::LetterIndex_t(common::CountTrailingZeros(childMask)));
+
+      const bool savedBad = common::CTriePoolOptimized::SaveCompiledDictionary(badDictionaryPath.c_str(), { root });
+
+      ROTA_ASSERT(savedBad  &&  "Couldn't save the compiled dictionary");
+
+      PatchCompiledDictionaryParent(badDictionaryPath, root, child);
+
+      const bool loadedBad = pRuntime->LoadCompiledDictionary(badDictionaryPath.c_str());
+
+      ROTA_ASSERT(!loadedBad  &&  "A compiled dictionary with a parent cycle was loaded");
+
+      std::remove(badDictionaryPath.c_str());
+    }
+
+    pRuntime.reset();
+    std::remove(compiledDictionaryPath.c_str());
+  }
+
+
+  void RunStridedBoardTestFromDir(const std::string& testFolder)
+  {
+    std::cout << "Will execute strided board test in: " << testFolder << std::endl;
+
+    const std::string rootFolder
+      = "bin/boggle_gamelib.test/testdata/" + testFolder;
+
+    boggle_game::CRuntime_TrieThreaded runtime;
+    runtime.LoadDictionary( std::string(rootFolder + "/dictionary.txt").c_str() );
+
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<char> boardArray;
+    LoadBoard(rootFolder, width, height, boardArray);
+
+    ///
+    /// Place the board in a wider buffer, with padding that must never be read
+    ///
+    static const size_t C_PADDING = 7;
+    const size_t stride = width + C_PADDING;
+
+    std::vector<char> stridedBoardArray(stride * height, '#');
+    for (uint32_t y = 0; y < height; y++)
+    {
+      std::copy_n(&boardArray[size_t(y) * width], width, &stridedBoardArray[y * stride]);
+    }
+
+    const auto result = runtime.FindWords(stridedBoardArray.data(), width, height, stride);
+
+    std::cout << "Found " << result.words.size() << " words for a score of " << result.score << std::endl;
+
+    CheckResultAgainstExpectedFile(rootFolder, result);
+  }
+
+
+  void RunResumedSearchTestFromDir(const std::string& testFolder)
+  {
+    std::cout << "Will execute resumed search test in: " << testFolder << std::endl;
+
+    static const uint32_t C_STEPS_PER_SLICE = 13;
+
+    const std::string rootFolder
+      = "bin/boggle_gamelib.test/testdata/" + testFolder;
+
+    boggle_game::CRuntime_TriePoolOptimized runtime;
+    runtime.LoadDictionary( std::string(rootFolder + "/dictionary.txt").c_str() );
+
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<char> boardArray;
+    LoadBoard(rootFolder, width, height, boardArray);
+
+    ///
+    /// Suspend the search every few steps, so it's resumed mid-path over and
+    /// over again
+    ///
+    runtime.BeginSearch(boardArray.data(), width, height);
+
+    uint32_t sliceCount = 1;
+    while (!runtime.ResumeSearch(C_STEPS_PER_SLICE))
+    {
+      sliceCount++;
+    }
+
+    boggle_game::SBoggleResults result;
+    result.words.resize(runtime.GetFoundWordCount(), nullptr);
+
+    if (!result.words.empty())
+    {
+      common::TContainerWriter<const char*> containerWriter;
+      containerWriter.container = result.words.data();
+
+      result.score = runtime.RetrieveWordsAndGetScore(containerWriter);
+    }
+
+    std::cout << "Searched in " << sliceCount << " slices" << std::endl;
+
+    CheckResultAgainstExpectedFile(rootFolder, result);
+  }
+
+
+  void RunPrefilterTestFromDir(const std::string& testFolder)
+  {
+    std::cout << "Will execute prefilter test in: " << testFolder << std::endl;
+
+    const std::string rootFolder
+      = "bin/boggle_gamelib.test/testdata/" + testFolder;
+
+    boggle_game::CRuntime_TriePoolOptimized runtime;
+    runtime.LoadDictionary( std::string(rootFolder + "/dictionary.txt").c_str() );
+
+    /// Filter whatever the size of the board
+    runtime.SetPrefilterMaxCells(UINT32_MAX);
+
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<char> boardArray;
+    LoadBoard(rootFolder, width, height, boardArray);
+
+    const auto result = runtime.FindWords(boardArray.data(), width, height);
+
+    std::cout << "Found " << result.words.size() << " words for a score of " << result.score << std::endl;
+
+    CheckResultAgainstExpectedFile(rootFolder, result);
+  }
+
+
+  void RunBandSolverTestFromDir(const std::string& testFolder, const uint32_t bandHeight)
+  {
+    std::cout << "Will execute band solver test in: " << testFolder << ", " << bandHeight << " rows per band" << std::endl;
+
+    const std::string rootFolder
+      = "bin/boggle_gamelib.test/testdata/" + testFolder;
+
+    auto pRuntime = boggle_game::CreateRuntimeSolver(boggle_game::EBoggleSolver::TriePoolOptimized);
+    pRuntime->LoadDictionary( std::string(rootFolder + "/dictionary.txt").c_str() );
+
+    ///
+    /// Stream the board from disk, one row at a time
+    ///
+    std::ifstream boardFileStream(rootFolder + "/board.txt", std::ifstream::binary);
+
+    std::string currentLine;
+    std::getline(boardFileStream, currentLine);
+
+    const uint32_t width = uint32_t(std::count_if(currentLine.cbegin(), currentLine.cend(), [](const char c) { return isalpha(c) != 0; }));
+
+    bool hasLine = bool(boardFileStream);
+
+    boggle_game::CBandSolver bandSolver(*pRuntime, bandHeight);
+
+    const auto result = bandSolver.FindWords(width,
+      [&](char* pRowOut)
+      {
+        if (!hasLine)
+        {
+          return false;
+        }
+
+        std::copy_if(currentLine.cbegin(), currentLine.cend(), pRowOut, [](const char c) { return isalpha(c) != 0; });
+
+        hasLine = bool(std::getline(boardFileStream, currentLine));
+
+        return true;
+      });
+
+    std::cout << "Found " << result.words.size() << " words for a score of " << result.score << std::endl;
+
+    CheckResultAgainstExpectedFile(rootFolder, result);
+  }
+
+
+  void RunNonSquareBoardTestFromDir(const std::string& testFolder, const uint32_t width, const uint32_t height)
+  {
+    std::cout << "Will execute non-square board test in: " << testFolder << ", " << width << "x" << height << std::endl;
+
+    const std::string rootFolder
+      = "bin/boggle_gamelib.test/testdata/" + testFolder;
+
+    std::vector<char> boardArray;
+    GenerateBoard(width, height, boardArray);
+
+    ///
+    /// Neighbours stay neighbours when the board is transposed, so it has to
+    /// give the same words. Any mix-up of width, height and stride won't.
+    ///
+    std::vector<char> transposedBoardArray(boardArray.size());
+    for (uint32_t y = 0; y < height; y++)
+    {
+      for (uint32_t x = 0; x < width; x++)
+      {
+        transposedBoardArray[size_t(x) * height + y] = boardArray[size_t(y) * width + x];
+      }
+    }
+
+    std::set<std::string> expectedWords;
+
+    for (const boggle_game::EBoggleSolver solver : {
+      boggle_game::EBoggleSolver::TriePoolOptimized,
+      boggle_game::EBoggleSolver::Simple,
+      boggle_game::EBoggleSolver::TrieThreaded,
+      boggle_game::EBoggleSolver::TrieCompact,
+      boggle_game::EBoggleSolver::Dawg,
+      boggle_game::EBoggleSolver::TrieParallel })
+    {
+      auto pRuntime = boggle_game::CreateRuntimeSolver(solver);
+      pRuntime->LoadDictionary( std::string(rootFolder + "/dictionary.txt").c_str() );
+
+      const auto result = pRuntime->FindWords(boardArray.data(), width, height);
+      const std::set<std::string> words(result.words.cbegin(), result.words.cend());
+
+      const auto transposedResult = pRuntime->FindWords(transposedBoardArray.data(), height, width);
+      const std::set<std::string> transposedWords(transposedResult.words.cbegin(), transposedResult.words.cend());
+
+      if (expectedWords.empty())
+      {
+        expectedWords = words;
+      }
+
+      ROTA_ASSERT(words.size() == result.words.size()  &&  "Found duplicate words.");
+      ROTA_ASSERT(words == expectedWords  &&  "Solvers disagree on a non-square board.");
+      ROTA_ASSERT(transposedWords == expectedWords  &&  "The transposed board gave different words.");
+      ROTA_ASSERT(transposedResult.score == result.score  &&  "The transposed board gave a different score.");
+    }
+
+    std::cout << "Found " << expectedWords.size() << " words" << std::endl;
+    std::cout << "Test passed!" << std::endl;
+  }
+
+
+  void RunSmallBoardTestFromDir(
+    const std::string& testFolder,
+    const uint32_t width,
+    const uint32_t height,
+    const boggle_game::EBoggleSolver solver
+  )
+  {
+    std::cout << "Will execute small board test in: " << testFolder << ", " << width << "x" << height << std::endl;
+
+    static const uint32_t C_BOARD_COUNT = 2000;
+
+    const std::string rootFolder
+      = "bin/boggle_gamelib.test/testdata/" + testFolder;
+
+    std::vector<char> boardArrays;
+    GenerateBoard(width, height * C_BOARD_COUNT, boardArrays);
+
+    const size_t cellCount = size_t(width) * height;
+
+    ///
+    /// The generic search of TrieCompact tells what every board should give,
+    /// and both are timed over the same boards
+    ///
+    std::vector<std::set<std::string>> expectedWords(C_BOARD_COUNT);
+    std::vector<uint32_t> expectedScores(C_BOARD_COUNT);
+
+    auto pReferenceRuntime = boggle_game::CreateRuntimeSolver(boggle_game::EBoggleSolver::TrieCompact);
+    pReferenceRuntime->LoadDictionary( std::string(rootFolder + "/dictionary.txt").c_str() );
+
+    const auto timeReferenceStart = std::chrono::steady_clock::now();
+
+    for (uint32_t i = 0; i < C_BOARD_COUNT; i++)
+    {
+      const auto result = pReferenceRuntime->FindWords(&boardArrays[i * cellCount], width, height);
+
+      expectedWords[i].insert(result.words.cbegin(), result.words.cend());
+      expectedScores[i] = result.score;
+    }
+
+    const auto timeReferenceEnd = std::chrono::steady_clock::now();
+
+    auto pRuntime = boggle_game::CreateRuntimeSolver(solver);
+    pRuntime->LoadDictionary( std::string(rootFolder + "/dictionary.txt").c_str() );
+
+    std::vector<boggle_game::SBoggleResults> results(C_BOARD_COUNT);
+
+    const auto timeStart = std::chrono::steady_clock::now();
+
+    for (uint32_t i = 0; i < C_BOARD_COUNT; i++)
+    {
+      results[i] = pRuntime->FindWords(&boardArrays[i * cellCount], width, height);
+    }
+
+    const auto timeEnd = std::chrono::steady_clock::now();
+
+    uint32_t totalWordCount = 0;
+
+    for (uint32_t i = 0; i < C_BOARD_COUNT; i++)
+    {
+      const std::set<std::string> words(results[i].words.cbegin(), results[i].words.cend());
+
+      ROTA_ASSERT(words.size() == results[i].words.size()  &&  "Found duplicate words.");
+      ROTA_ASSERT(words == expectedWords[i]  &&  "The solver found different words on a small board.");
+      ROTA_ASSERT(results[i].score == expectedScores[i]  &&  "The solver gave a different score on a small board.");
+
+      totalWordCount += uint32_t(words.size());
+    }
+
+    const auto getMicrosecondsPerBoard = [](const auto duration)
+    {
+      return double(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count()) / (1000.0 * C_BOARD_COUNT);
+    };
+
+    std::cout
+      << "Found " << totalWordCount << " words on " << C_BOARD_COUNT << " boards" << std::endl
+      << "  FindWords         : " << getMicrosecondsPerBoard(timeEnd - timeStart) << " us per board" << std::endl
+      << "  FindWords, compact: " << getMicrosecondsPerBoard(timeReferenceEnd - timeReferenceStart) << " us per board" << std::endl
+      ;
+
+    std::cout << "Test passed!" << std::endl;
+  }
+
+
+  void RunBatchTestFromDir(const std::string& testFolder, const uint32_t width, const uint32_t height)
+  {
+    std::cout << "Will execute batch test in: " << testFolder << ", " << width << "x" << height << std::endl;
+
+    static const uint32_t C_BOARD_COUNT = 2003;
+
+    const std::string rootFolder
+      = "bin/boggle_gamelib.test/testdata/" + testFolder;
+
+    std::vector<char> boardArrays;
+    GenerateBoard(width, height * C_BOARD_COUNT, boardArrays);
+
+    std::vector<const char*> boards;
+    for (uint32_t i = 0; i < C_BOARD_COUNT; i++)
+    {
+      boards.push_back(&boardArrays[size_t(i) * width * height]);
+    }
+
+    boggle_game::CRuntime_Bitboard runtime;
+    runtime.LoadDictionary( std::string(rootFolder + "/dictionary.txt").c_str() );
+
+    std::vector<boggle_game::SBoggleResults> expectedResults;
+    for (const char* pBoard : boards)
+    {
+      expectedResults.push_back(runtime.FindWords(pBoard, width, height));
+    }
+
+    const auto timeStart = std::chrono::steady_clock::now();
+    const auto results = runtime.FindWordsBatch(boards.data(), C_BOARD_COUNT, width, height);
+    const auto timeEnd = std::chrono::steady_clock::now();
+
+    ROTA_ASSERT(results.size() == C_BOARD_COUNT  &&  "Missing results.");
+
+    for (uint32_t i = 0; i < C_BOARD_COUNT; i++)
+    {
+      const std::set<std::string> words(results[i].words.cbegin(), results[i].words.cend());
+      const std::set<std::string> expectedWords(expectedResults[i].words.cbegin(), expectedResults[i].words.cend());
+
+      ROTA_ASSERT(words.size() == results[i].words.size()  &&  "Found duplicate words.");
+      ROTA_ASSERT(words == expectedWords  &&  "The batch found different words.");
+      ROTA_ASSERT(results[i].score == expectedResults[i].score  &&  "The batch gave a different score.");
+    }
+
+    std::cout
+      << "  Batch : " << double(std::chrono::duration_cast<std::chrono::nanoseconds>(timeEnd - timeStart).count()) / (1000.0 * C_BOARD_COUNT) << " us per board" << std::endl
+      ;
+
+    std::cout << "Test passed!" << std::endl;
+  }
+
+
+  void RunIncrementalTestFromDir(const std::string& testFolder, const uint32_t width, const uint32_t height)
+  {
+    std::cout << "Will execute incremental test in: " << testFolder << ", " << width << "x" << height << std::endl;
+
+    static const uint32_t C_EDIT_COUNT = 500;
+
+    const std::string rootFolder
+      = "bin/boggle_gamelib.test/testdata/" + testFolder;
+
+    std::vector<char> boardArray;
+    GenerateBoard(width, height, boardArray);
+
+    boggle_game::CRuntime_Incremental runtime;
+    runtime.LoadDictionary( std::string(rootFolder + "/dictionary.txt").c_str() );
+
+    auto pReferenceRuntime = boggle_game::CreateRuntimeSolver(boggle_game::EBoggleSolver::TrieCompact);
+    pReferenceRuntime->LoadDictionary( std::string(rootFolder + "/dictionary.txt").c_str() );
+
+    /// The fastest full re-solve, to compare with. The pool is shared, so it
+    /// has to use the same tries.
+    boggle_game::CRuntime_FixedBoard fullRuntime;
+    fullRuntime.AttachTrieRoot(runtime.GetTrieRoot());
+
+    const auto result = runtime.FindWords(boardArray.data(), width, height);
+    std::set<std::string> words(result.words.cbegin(), result.words.cend());
+
+    std::chrono::steady_clock::duration editDuration(0);
+    std::chrono::steady_clock::duration scoreDuration(0);
+    std::chrono::steady_clock::duration fullDuration(0);
+
+    for (uint32_t i = 0; i < C_EDIT_COUNT; i++)
+    {
+      ///
+      /// Mostly single letters, as in an editor, and now and then a few at
+      /// once, which may be the same cell more than once
+      ///
+      std::vector<boggle_game::SBoardEdit> edits((i % 7) ? 1 : 1 + (rand() % 4));
+
+      for (boggle_game::SBoardEdit& edit : edits)
+      {
+        edit.x = rand() % width;
+        edit.y = rand() % height;
+        edit.letter = char('a' + (rand() % 26));
+
+        boardArray[size_t(edit.y) * width + edit.x] = edit.letter;
+      }
+
+      const auto timeFullStart = std::chrono::steady_clock::now();
+      const auto fullResult = fullRuntime.FindWords(boardArray.data(), width, height);
+      fullDuration += std::chrono::steady_clock::now() - timeFullStart;
+
+      ///
+      /// Score the edits and take them back, as the board optimizer does.
+      /// The diff below then shows whether everything was put back.
+      ///
+      const auto timeScoreStart = std::chrono::steady_clock::now();
+      const uint32_t score = runtime.ApplyEditsForScore(edits.data(), uint32_t(edits.size()));
+      scoreDuration += std::chrono::steady_clock::now() - timeScoreStart;
+
+      ROTA_ASSERT(fullResult.score == score  &&  "Wrong score after the edits.");
+
+      runtime.UndoEdits();
+
+      const auto timeStart = std::chrono::steady_clock::now();
+      const auto diff = runtime.ApplyEdits(edits.data(), uint32_t(edits.size()));
+      editDuration += std::chrono::steady_clock::now() - timeStart;
+
+      ROTA_ASSERT(fullResult.score == diff.score  &&  "Wrong score after the edits.");
+
+      for (const char* pWord : diff.removedWords)
+      {
+        ROTA_ASSERT(words.erase(pWord) == 1  &&  "Removed a word that wasn't there.");
+      }
+
+      for (const char* pWord : diff.addedWords)
+      {
+        ROTA_ASSERT(words.insert(pWord).second  &&  "Added a word that was already there.");
+      }
+
+      const auto expectedResult = pReferenceRuntime->FindWords(boardArray.data(), width, height);
+      const std::set<std::string> expectedWords(expectedResult.words.cbegin(), expectedResult.words.cend());
+
+      ROTA_ASSERT(words == expectedWords  &&  "The diff doesn't lead to the words on the board.");
+      ROTA_ASSERT(diff.score == expectedResult.score  &&  "Wrong score after the edits.");
+    }
+
+    const auto currentResult = runtime.GetCurrentResults();
+    ROTA_ASSERT(std::set<std::string>(currentResult.words.cbegin(), currentResult.words.cend()) == words  &&  "The current words don't match the diffs.");
+
+    std::cout
+      << "Edited " << C_EDIT_COUNT << " times, " << words.size() << " words left" << std::endl
+      << "  ApplyEdits         : " << double(std::chrono::duration_cast<std::chrono::nanoseconds>(editDuration).count()) / (1000.0 * C_EDIT_COUNT) << " us per edit" << std::endl
+      << "  ApplyEditsForScore : " << double(std::chrono::duration_cast<std::chrono::nanoseconds>(scoreDuration).count()) / (1000.0 * C_EDIT_COUNT) << " us per edit" << std::endl
+      << "  Full re-solve      : " << double(std::chrono::duration_cast<std::chrono::nanoseconds>(fullDuration).count()) / (1000.0 * C_EDIT_COUNT) << " us per edit" << std::endl
+      ;
+
+    std::cout << "Test passed!" << std::endl;
+  }
+
+
+  void RunBoardOptimizerTestFromDir(const std::string& testFolder, const uint32_t width, const uint32_t height, const uint32_t stepCount)
+  {
+    std::cout << "Will execute board optimizer test in: " << testFolder << ", " << width << "x" << height << std::endl;
+
+    const std::string rootFolder
+      = "bin/boggle_gamelib.test/testdata/" + testFolder;
+
+    boggle_game::CRuntime_TriePoolOptimized runtime;
+    runtime.LoadDictionary( std::string(rootFolder + "/dictionary.txt").c_str() );
+
+    auto pReferenceRuntime = boggle_game::CreateRuntimeSolver(boggle_game::EBoggleSolver::TrieCompact);
+    pReferenceRuntime->LoadDictionary( std::string(rootFolder + "/dictionary.txt").c_str() );
+
+    const boggle_game::CBoardOptimizer optimizer(runtime);
+
+    boggle_game::CBoardOptimizer::SSettings settings;
+    settings.width = width;
+    settings.height = height;
+    settings.chainCount = 4;
+    settings.threadCount = 4;
+    settings.stepCount = stepCount;
+    settings.seed = 42;
+
+    const auto runOptimizer = [&](const char* pName, const boggle_game::CBoardOptimizer::SSettings& currentSettings)
+    {
+      const auto timeStart = std::chrono::steady_clock::now();
+      const auto result = optimizer.Optimize(currentSettings);
+      const auto timeEnd = std::chrono::steady_clock::now();
+
+      const double seconds = std::chrono::duration<double>(timeEnd - timeStart).count();
+
+      std::cout
+        << "  " << pName << " : score " << result.score << ", "
+        << uint64_t(double(result.evaluatedBoardCount) / seconds) << " boards/sec" << std::endl
+        ;
+
+      ROTA_ASSERT(result.board.size() == size_t(width) * height  &&  "Wrong board size.");
+      ROTA_ASSERT(result.evaluatedBoardCount == uint64_t(currentSettings.chainCount) * (currentSettings.stepCount + 1)  &&  "Boards went unscored.");
+      ROTA_ASSERT(pReferenceRuntime->FindWords(result.board.data(), width, height).score == result.score  &&  "The best board has a different score.");
+
+      return result;
+    };
+
+    const auto result = runOptimizer("Annealing, full       ", settings);
+
+    ///
+    /// Neither the number of threads nor the way boards are scored may change
+    /// the outcome
+    ///
+    settings.threadCount = 1;
+    const auto singleThreadResult = runOptimizer("Annealing, one thread ", settings);
+
+    settings.scoring = boggle_game::CBoardOptimizer::EScoring::Incremental;
+    const auto incrementalResult = runOptimizer("Annealing, incremental", settings);
+
+    ROTA_ASSERT(singleThreadResult.board == result.board  &&  "The threads changed the result.");
+    ROTA_ASSERT(incrementalResult.board == result.board  &&  "Incremental scoring changed the result.");
+
+    settings.scoring = boggle_game::CBoardOptimizer::EScoring::Full;
+    settings.startTemperature = 0;
+    runOptimizer("Hill climbing         ", settings);
+
+    std::cout << "Test passed!" << std::endl;
+  }
+
+
+  void RunHugeBandBoardTestFromDir(const std::string& testFolder, const uint32_t width, const uint32_t height)
+  {
+    std::cout << "Will execute huge band board test in: " << testFolder << ", " << width << "x" << height << std::endl;
+
+    const std::string rootFolder
+      = "bin/boggle_gamelib.test/testdata/" + testFolder;
+
+    auto pRuntime = boggle_game::CreateRuntimeSolver(boggle_game::EBoggleSolver::TrieParallel);
+    pRuntime->LoadDictionary( std::string(rootFolder + "/dictionary.txt").c_str() );
+
+    uint32_t tileWidth = 0;
+    uint32_t tileHeight = 0;
+    std::vector<char> tileArray;
+    LoadBoard(rootFolder, tileWidth, tileHeight, tileArray);
+
+    ///
+    /// The board repeats the one from the folder over and over, so it's never
+    /// held in memory as a whole. Bands as high as the folder's board start
+    /// with the full dictionary at their top, so they are quick to search.
+    ///
+    uint32_t currentY = 0;
+
+    boggle_game::CBandSolver bandSolver(*pRuntime, tileHeight);
+
+    const auto timeStart = std::chrono::steady_clock::now();
+
+    const auto result = bandSolver.FindWords(width,
+      [&](char* pRowOut)
+      {
+        if (currentY == height)
+        {
+          return false;
+        }
+
+        const char* pTileRow = &tileArray[size_t(currentY % tileHeight) * tileWidth];
+
+        for (uint32_t x = 0; x < width; x += tileWidth)
+        {
+          std::copy_n(pTileRow, std::min(tileWidth, width - x), pRowOut + x);
+        }
+
+        currentY++;
+
+        return true;
+      });
+
+    const auto timeEnd = std::chrono::steady_clock::now();
+
+    std::cout
+      << "Found " << result.words.size() << " words for a score of " << result.score
+      << " on " << (uint64_t(width) * height) << " cells" << std::endl
+      << "  FindWords : " << std::chrono::duration_cast<std::chrono::milliseconds>(timeEnd - timeStart).count() << " ms" << std::endl
+      ;
+
+    CheckResultAgainstExpectedFile(rootFolder, result);
+  }
+
+
+  void RunHugeIndexTest()
+  {
+    std::cout << "Will execute huge index test" << std::endl;
+
+    static const uint32_t C_WIDTH = 70001;
+    static const uint32_t C_HEIGHT = 65537;
+
+    ROTA_ASSERT(uint64_t(C_WIDTH) * C_HEIGHT > UINT32_MAX  &&  "The board must have more than 2^32 cells");
+
+    ///
+    /// Offsets into a view of the whole board. Nothing is read, so the board
+    /// doesn't have to exist.
+    ///
+    {
+      const size_t stride = size_t(C_WIDTH) + 7;
+      const common::SBoardView view(nullptr, C_WIDTH, C_HEIGHT, stride);
+
+      const uint64_t expectedIndex = (uint64_t(C_HEIGHT - 1) * stride) + (C_WIDTH - 1);
+
+      ROTA_ASSERT(expectedIndex > UINT32_MAX);
+      ROTA_ASSERT(view.GetIndex(C_WIDTH - 1, C_HEIGHT - 1) == expectedIndex  &&  "The board view offset was truncated");
+      ROTA_ASSERT(view.GetIndex(3, C_HEIGHT / 2) == (uint64_t(C_HEIGHT / 2) * stride) + 3  &&  "The board view offset was truncated");
+    }
+
+    ///
+    /// Every tile of the board is handed out exactly once, and together they
+    /// cover every cell. There's no search, so nothing ends early.
+    ///
+    {
+      static const uint32_t C_OWNER_COUNT = 4;
+
+      const auto tiling = boggle_game::CRuntime_TrieParallel::GetTiling(C_WIDTH, C_HEIGHT);
+
+      common::CWorkStealingRanges tasks;
+      tasks.Initialize(C_OWNER_COUNT, tiling.tileCount);
+
+      std::unique_ptr<std::atomic<uint8_t>[]> takenCounts(new std::atomic<uint8_t>[tiling.tileCount]());
+      std::array<uint64_t, C_OWNER_COUNT> cellCounts = {};
+
+      std::vector<std::thread> threads;
+      for (uint32_t owner = 0; owner < C_OWNER_COUNT; owner++)
+      {
+        threads.emplace_back([&, owner]()
+          {
+            uint32_t tile = 0;
+            while (tasks.Pop(owner, tile))
+            {
+              takenCounts[tile]++;
+
+              uint32_t beginX, beginY, endX, endY;
+              tiling.GetTileBounds(tile, beginX, beginY, endX, endY);
+
+              cellCounts[owner] += uint64_t(endX - beginX) * (endY - beginY);
+            }
+          });
+      }
+
+      for (std::thread& thread : threads)
+      {
+        thread.join();
+      }
+
+      for (uint32_t tile = 0; tile < tiling.tileCount; tile++)
+      {
+        ROTA_ASSERT(takenCounts[tile] == 1  &&  "A tile wasn't handed out exactly once");
+      }
+
+      uint64_t cellCount = 0;
+      for (const uint64_t ownerCellCount : cellCounts)
+      {
+        cellCount += ownerCellCount;
+      }
+
+      ROTA_ASSERT(cellCount == uint64_t(C_WIDTH) * C_HEIGHT  &&  "The tiles don't cover the board");
+
+      std::cout << "Handed out " << tiling.tileCount << " tiles of " << tiling.tileSize << "x" << tiling.tileSize << " over " << cellCount << " cells" << std::endl;
+    }
+
+    ///
+    /// A board too big for 2^32 tiles of the default size gets bigger ones,
+    /// and the last tile still ends at the corner
+    ///
+    {
+      const auto tiling = boggle_game::CRuntime_TrieParallel::GetTiling(UINT32_MAX, UINT32_MAX);
+
+      uint32_t beginX, beginY, endX, endY;
+      tiling.GetTileBounds(tiling.tileCount - 1, beginX, beginY, endX, endY);
+
+      ROTA_ASSERT(uint64_t(tiling.tileCountX) * ((uint64_t(UINT32_MAX) + tiling.tileSize - 1) / tiling.tileSize) == tiling.tileCount  &&  "The tile count overflowed");
+      ROTA_ASSERT(endX == UINT32_MAX  &&  endY == UINT32_MAX  &&  "The last tile doesn't end at the corner");
+    }
+
+    std::cout << "Test passed!" << std::endl;
+  }
+
+
+  void RunThreadPoolTestFromDir(const std::string& testFolder)
+  {
+    std::cout << "Will execute thread pool test in: " << testFolder << std::endl;
+
+    static const uint32_t C_WORKER_COUNT = 4;
+    static const uint32_t C_SOLVE_COUNT = 1000;
+
+    const std::string rootFolder
+      = "bin/boggle_gamelib.test/testdata/" + testFolder;
+
+    ///
+    /// More workers than most test machines have CPUs, all pinned to the first
+    /// one, and many small boards - so the pool is reused over and over.
+    ///
+    boggle_game::CRuntime_TrieThreaded runtime(C_WORKER_COUNT, { 0 });
+    runtime.LoadDictionary( std::string(rootFolder + "/dictionary.txt").c_str() );
+
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<char> boardArray;
+    LoadBoard(rootFolder, width, height, boardArray);
+
+    const auto timeStart = std::chrono::steady_clock::now();
+
+    const auto result = runtime.FindWords(boardArray.data(), width, height);
+
+    for (uint32_t i = 1; i < C_SOLVE_COUNT; i++)
+    {
+      const auto currentResult = runtime.FindWords(boardArray.data(), width, height);
+
+      ROTA_ASSERT(currentResult.words.size() == result.words.size()  &&  "Solving the same board again gave a different result.");
+      ROTA_ASSERT(currentResult.score == result.score  &&  "Solving the same board again gave a different score.");
+    }
+
+    const auto timeEnd = std::chrono::steady_clock::now();
+
+    std::cout
+      << "Found " << result.words.size() << " words for a score of " << result.score << std::endl
+      << "  FindWords : " << (std::chrono::duration_cast<std::chrono::microseconds>(timeEnd - timeStart).count() / C_SOLVE_COUNT) << " us per board" << std::endl
+      ;
+
+    CheckResultAgainstExpectedFile(rootFolder, result);
+  }
+
+
+  void RunPrefixTasksTestFromDir(const std::string& testFolder)
+  {
+    std::cout << "Will execute prefix tasks test in: " << testFolder << std::endl;
+
+    const std::string rootFolder
+      = "bin/boggle_gamelib.test/testdata/" + testFolder;
+
+    boggle_game::CRuntime_TrieParallel runtime(4);
+    runtime.SetTaskSplit(boggle_game::CRuntime_TrieParallel::ETaskSplit::Prefixes);
+    runtime.LoadDictionary( std::string(rootFolder + "/dictionary.txt").c_str() );
+
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<char> boardArray;
+    LoadBoard(rootFolder, width, height, boardArray);
+
+    const auto timeStart = std::chrono::steady_clock::now();
+
+    const auto result = runtime.FindWords(boardArray.data(), width, height);
+
+    const auto timeEnd = std::chrono::steady_clock::now();
+
+    std::cout
+      << "Found " << result.words.size() << " words for a score of " << result.score << std::endl
+      << "  FindWords : " << std::chrono::duration_cast<std::chrono::milliseconds>(timeEnd - timeStart).count() << " ms" << std::endl
+      ;
+
+    CheckResultAgainstExpectedFile(rootFolder, result);
+  }
+
+
+  void RunLargeDictionaryTest()
+  {
+    std::cout << "Will execute large dictionary test" << std::endl;
+
+    ///
+    /// Random words give very little sharing in the trie, so this needs far
+    /// more tries than any of the real dictionaries.
+    ///
+    static const uint32_t C_WORD_COUNT = 200 * 1000;
+    static const uint32_t C_MIN_TRIE_COUNT = 1000 * 1000;
+
+    const std::string dictionaryPath = "bin/boggle_gamelib.test/testdata/large_dictionary.txt";
+    {
+      std::ofstream fileStreamOut(dictionaryPath, std::ofstream::binary);
+
+      for (uint32_t i = 0; i < C_WORD_COUNT; i++)
+      {
+        for (uint32_t letter = 0; letter < 12; letter++)
+        {
+          fileStreamOut << char((rand() % ('z' - 'a')) + 'a');
+        }
+
+        fileStreamOut << '\n';
+      }
+    }
+
+    auto pRuntime = boggle_game::CreateRuntimeSolver(boggle_game::EBoggleSolver::TrieThreaded);
+
+    pRuntime->LoadDictionary(dictionaryPath.c_str());
+
+    PrintTriePoolUsage();
+
+    const common::SArenaUsage usage = common::CTriePoolOptimized::GetPoolUsage();
+
+    ROTA_ASSERT(usage.usedCount >= C_MIN_TRIE_COUNT  &&  "Expected a lot more tries");
+    ROTA_ASSERT(usage.capacityCount >= usage.usedCount  &&  "The pool didn't grow");
+
+    std::vector<char> boardArray;
+    GenerateBoard(100, 100, boardArray);
+
+    const auto result = pRuntime->FindWords(boardArray.data(), 100, 100);
+
+    std::cout << "Found " << result.words.size() << " words for a score of " << result.score << std::endl;
+    std::cout << "Test passed!" << std::endl;
+
+    pRuntime.reset();
+    std::remove(dictionaryPath.c_str());
+  }
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+int main()
+{
+  /// Regression tests
+  boggle_game_test::RunTestFromDir("regression_qu1", 2);
+  boggle_game_test::RunTestFromDir("regression_qu2", 2);
+  boggle_game_test::RunTestFromDir("regression_ensure-non-duplicates", 2);
+  boggle_game_test::RunTestFromDir("regression_whole-dictionary", 2);
+  boggle_game_test::RunTestFromDir("regression_whole-dictionary", 2, boggle_game::EBoggleSolver::TrieParallel);
+  boggle_game_test::RunTestFromDir("regression_qu1", 2, boggle_game::EBoggleSolver::TrieCompact);
+  boggle_game_test::RunTestFromDir("regression_qu2", 2, boggle_game::EBoggleSolver::TrieCompact);
+  boggle_game_test::RunTestFromDir("regression_qu1", 2, boggle_game::EBoggleSolver::Dawg);
+  boggle_game_test::RunTestFromDir("regression_qu2", 2, boggle_game::EBoggleSolver::Dawg);
+  boggle_game_test::RunTestFromDir("regression_qu1", 2, boggle_game::EBoggleSolver::TrieParallel);
+  boggle_game_test::RunTestFromDir("regression_qu2", 2, boggle_game::EBoggleSolver::TrieParallel);
+  boggle_game_test::RunTestFromDir("regression_qu1", 2, boggle_game::EBoggleSolver::FixedBoard);
+  boggle_game_test::RunTestFromDir("regression_qu2", 2, boggle_game::EBoggleSolver::FixedBoard);
+  boggle_game_test::RunTestFromDir("regression_ensure-non-duplicates", 2, boggle_game::EBoggleSolver::FixedBoard);
+  boggle_game_test::RunTestFromDir("regression_qu1", 2, boggle_game::EBoggleSolver::Bitboard);
+  boggle_game_test::RunTestFromDir("regression_qu2", 2, boggle_game::EBoggleSolver::Bitboard);
+  boggle_game_test::RunTestFromDir("regression_ensure-non-duplicates", 2, boggle_game::EBoggleSolver::Bitboard);
+  boggle_game_test::RunTestFromDir("regression_whole-dictionary", 2, boggle_game::EBoggleSolver::Bitboard);
+  boggle_game_test::RunTestFromDir("regression_qu1", 2, boggle_game::EBoggleSolver::Incremental);
+  boggle_game_test::RunTestFromDir("regression_qu2", 2, boggle_game::EBoggleSolver::Incremental);
+  boggle_game_test::RunTestFromDir("regression_ensure-non-duplicates", 2, boggle_game::EBoggleSolver::Incremental);
+  boggle_game_test::RunCompiledDictionaryTestFromDir("regression_qu1");
+  boggle_game_test::RunStridedBoardTestFromDir("regression_qu2");
+  boggle_game_test::RunThreadPoolTestFromDir("regression_qu2");
+  boggle_game_test::RunResumedSearchTestFromDir("regression_qu2");
+  boggle_game_test::RunPrefilterTestFromDir("regression_qu1");
+  boggle_game_test::RunPrefilterTestFromDir("regression_qu2");
+  boggle_game_test::RunResumedSearchTestFromDir("regression_whole-dictionary");
+  boggle_game_test::RunBandSolverTestFromDir("regression_qu2", 1);
+  boggle_game_test::RunNonSquareBoardTestFromDir("performance_huge", 23, 61);
+  boggle_game_test::RunHugeBandBoardTestFromDir("regression_whole-dictionary", 65600, 65600);
+  boggle_game_test::RunHugeIndexTest();
+  boggle_game_test::RunPrefixTasksTestFromDir("regression_qu2");
+  boggle_game_test::RunLargeDictionaryTest();
+
+  /// Performance test
+  boggle_game_test::RunTestFromDir("performance_huge", 2);
+  boggle_game_test::RunTestFromDir("performance_huge", 1, boggle_game::EBoggleSolver::TrieCompact);
+  boggle_game_test::RunTestFromDir("performance_huge", 1, boggle_game::EBoggleSolver::Dawg);
+  boggle_game_test::RunStridedBoardTestFromDir("performance_huge");
+  boggle_game_test::RunPrefixTasksTestFromDir("performance_huge");
+  boggle_game_test::RunResumedSearchTestFromDir("performance_huge");
+  boggle_game_test::RunPrefilterTestFromDir("performance_huge");
+  boggle_game_test::RunBandSolverTestFromDir("performance_huge", 1);
+  boggle_game_test::RunBandSolverTestFromDir("performance_huge", 20);
+  boggle_game_test::RunSmallBoardTestFromDir("performance_huge", 4, 4, boggle_game::EBoggleSolver::FixedBoard);
+  boggle_game_test::RunSmallBoardTestFromDir("performance_huge", 5, 5, boggle_game::EBoggleSolver::FixedBoard);
+  boggle_game_test::RunSmallBoardTestFromDir("performance_huge", 4, 4, boggle_game::EBoggleSolver::Bitboard);
+  boggle_game_test::RunSmallBoardTestFromDir("performance_huge", 8, 8, boggle_game::EBoggleSolver::Bitboard);
+  boggle_game_test::RunSmallBoardTestFromDir("performance_huge", 13, 3, boggle_game::EBoggleSolver::Bitboard);
+  boggle_game_test::RunBatchTestFromDir("performance_huge", 3, 3);
+  boggle_game_test::RunBatchTestFromDir("performance_huge", 4, 4);
+  boggle_game_test::RunBatchTestFromDir("performance_huge", 13, 3);
+  boggle_game_test::RunIncrementalTestFromDir("performance_huge", 4, 4);
+  boggle_game_test::RunIncrementalTestFromDir("performance_huge", 5, 5);
+  boggle_game_test::RunIncrementalTestFromDir("performance_huge", 40, 30);
+  boggle_game_test::RunBoardOptimizerTestFromDir("performance_huge", 4, 4, 1500);
+  boggle_game_test::RunBoardOptimizerTestFromDir("performance_huge", 6, 6, 1500);
+  boggle_game_test::RunBoardOptimizerTestFromDir("performance_huge", 32, 20, 100);
+  boggle_game_test::RunTestFromDir("performance_monster");
+  boggle_game_test::RunTestFromDir("performance_titan");
+  boggle_game_test::RunTestFromDir("performance_titan", 1, boggle_game::EBoggleSolver::TrieParallel);
+  boggle_game_test::RunCompiledDictionaryTestFromDir("performance_titan");
+  boggle_game_test::RunTestFromDir("performance_titans-creator");
+
+
+  return 0;
+}
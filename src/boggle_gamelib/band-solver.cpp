@@ -0,0 +1,102 @@
+#include "band-solver.hpp"
+
+#include "runtime_base.hpp"
+
+#include <cassert>
+#include <cstring>
+
+
+// ----------------------------------------------------------------------------
+
+
+boggle_game::CBandSolver::CBandSolver(IRuntime& runtime, const uint32_t bandHeight)
+  : m_runtime(runtime)
+  , m_bandHeight(bandHeight)
+{
+  assert(m_bandHeight > 0);
+}
+
+
+boggle_game::SBoggleResults boggle_game::CBandSolver::FindWords(const uint32_t width, const ReadRow_t& readRow)
+{
+  SBoggleResults result;
+
+  m_foundWords.clear();
+
+  if (!width)
+  {
+    return result;
+  }
+
+  ///
+  /// The window holds one band, followed by the overlap with the next one.
+  /// Once searched, the overlap is moved to the top and becomes part of the
+  /// next band, so every row is read exactly once.
+  ///
+  const uint32_t windowHeight = m_bandHeight + C_OVERLAP_HEIGHT;
+
+  m_window.resize(size_t(width) * windowHeight);
+
+  uint32_t rowCount = 0;
+
+  for (;;)
+  {
+    uint32_t newRowCount = 0;
+
+    for (; rowCount < windowHeight; rowCount++, newRowCount++)
+    {
+      if (!readRow(&m_window[size_t(rowCount) * width]))
+      {
+        break;
+      }
+    }
+
+    ///
+    /// Nothing new since the last band, whose overlap was already searched
+    ///
+    if (!newRowCount)
+    {
+      break;
+    }
+
+    AddBandResults(m_runtime.FindWords(m_window.data(), width, rowCount), result);
+
+    if (rowCount < windowHeight)
+    {
+      break;
+    }
+
+    memmove(
+      m_window.data(),
+      &m_window[size_t(rowCount - C_OVERLAP_HEIGHT) * width],
+      size_t(C_OVERLAP_HEIGHT) * width);
+
+    rowCount = C_OVERLAP_HEIGHT;
+  }
+
+  m_foundWords.clear();
+
+  return result;
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void boggle_game::CBandSolver::AddBandResults(const SBoggleResults& bandResults, SBoggleResults& resultsOut)
+{
+  ///
+  /// The words point into the dictionary of the runtime, so they stay valid
+  /// from one band to the next
+  ///
+  for (const char* pWord : bandResults.words)
+  {
+    const std::string_view word(pWord);
+
+    if (m_foundWords.insert(word).second)
+    {
+      resultsOut.words.push_back(pWord);
+      resultsOut.score += CRuntime_Base::GetScoreForWordLength(word.length());
+    }
+  }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+///
+/// Solves boards too large to be held in memory, a band of rows at a time
+///
+
+// ----------------------------------------------------------------------------
+
+
+#include <include/iruntime.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+
+// ----------------------------------------------------------------------------
+
+
+namespace boggle_game
+{
+  class CBandSolver
+  {
+  public:
+
+    /// Fill <pRowOut> with the next row of the board, which is <width>
+    /// letters. Return false once there are no more rows.
+    typedef std::function<bool(char* pRowOut)> ReadRow_t;
+
+    static const uint32_t C_DEFAULT_BAND_HEIGHT = 256;
+
+    /// <runtime> must have its dictionary loaded, and is used for every band
+    explicit CBandSolver(IRuntime& runtime, const uint32_t bandHeight = C_DEFAULT_BAND_HEIGHT);
+
+    /// Solve a board of <width> columns and any number of rows. Only one band
+    /// and its overlap are ever held in memory, besides the words found.
+    SBoggleResults FindWords(const uint32_t width, const ReadRow_t& readRow);
+
+  private:
+    /// A word can't span more rows than it has letters, so every word that
+    /// starts in a band fits in it and the following overlap.
+    static const uint32_t C_OVERLAP_HEIGHT = IRuntime::C_MAX_WORD_LENGTH - 1;
+
+    void AddBandResults(const SBoggleResults& bandResults, SBoggleResults& resultsOut);
+
+  private:
+    IRuntime& m_runtime;
+    const uint32_t m_bandHeight;
+
+    std::vector<char> m_window;
+
+    /// Words are found again in the overlap, so keep track of those reported
+    std::unordered_set<std::string_view> m_foundWords;
+  };
+}
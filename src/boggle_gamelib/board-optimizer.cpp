@@ -0,0 +1,235 @@
+#include "board-optimizer.hpp"
+
+#include "runtime_bitboard.hpp"
+#include "runtime_fixed-board.hpp"
+#include "runtime_incremental.hpp"
+#include "runtime_trie-pool-optimized.hpp"
+
+#include <common/threading/thread-pool.hpp>
+
+#include <cassert>
+#include <cmath>
+#include <random>
+
+
+// ----------------------------------------------------------------------------
+
+
+boggle_game::CBoardOptimizer::CBoardOptimizer(const CRuntime_TriePoolOptimized& dictionaryRuntime)
+  : m_dictionaryRuntime(dictionaryRuntime)
+{
+}
+
+
+boggle_game::CBoardOptimizer::SResult boggle_game::CBoardOptimizer::Optimize(const SSettings& settings) const
+{
+  assert(settings.width > 0 && settings.height > 0);
+  assert(settings.chainCount > 0);
+
+  std::vector<SResult> chainResults(settings.chainCount);
+
+  ///
+  /// The calling thread runs chains as well
+  ///
+  common::CThreadPool threadPool;
+
+  if (settings.threadCount > 1)
+  {
+    threadPool.Start(settings.threadCount - 1, {});
+  }
+
+  threadPool.RunForEachIndex(settings.chainCount,
+    [&](const size_t chain)
+    {
+      chainResults[chain] = RunChain(settings, uint32_t(chain));
+    });
+
+  threadPool.Stop();
+
+  ///
+  /// Ties go to the lowest chain, so the result doesn't depend on which
+  /// chain finished first
+  ///
+  SResult result;
+
+  for (SResult& chainResult : chainResults)
+  {
+    result.evaluatedBoardCount += chainResult.evaluatedBoardCount;
+
+    if (result.board.empty() || chainResult.score > result.score)
+    {
+      result.board = std::move(chainResult.board);
+      result.score = chainResult.score;
+    }
+  }
+
+  return result;
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+boggle_game::CBoardOptimizer::SResult boggle_game::CBoardOptimizer::RunChain(const SSettings& settings, const uint32_t chain) const
+{
+  std::mt19937_64 random(GetChainSeed(settings.seed, chain));
+
+  /// Same on every platform, unlike the standard distributions
+  const auto getRandomLetter = [&]() { return char('a' + (random() % C_LETTER_COUNT)); };
+  const auto getRandomUnit = [&]() { return double(random() >> 11) * (1.0 / double(uint64_t(1) << 53)); };
+
+  const uint32_t cellCount = settings.width * settings.height;
+
+  std::vector<char> board(cellCount);
+  for (char& letter : board)
+  {
+    letter = getRandomLetter();
+  }
+
+  const std::unique_ptr<CRuntime_TriePoolOptimized> pRuntime = CreateChainRuntime(settings);
+  CRuntime_Incremental* pIncrementalRuntime = IsScoringIncrementally(settings)
+    ? static_cast<CRuntime_Incremental*>(pRuntime.get())
+    : nullptr;
+
+  uint32_t currentScore = pIncrementalRuntime
+    ? pIncrementalRuntime->FindWords(board.data(), settings.width, settings.height).score
+    : pRuntime->FindScore(board.data(), settings.width, settings.height);
+
+  SResult result;
+  result.board = board;
+  result.score = currentScore;
+  result.evaluatedBoardCount = 1;
+
+  const double temperatureFactor = (settings.startTemperature > 0 && settings.stepCount > 1)
+    ? std::pow(settings.endTemperature / settings.startTemperature, 1.0 / double(settings.stepCount - 1))
+    : 1.0;
+
+  double temperature = settings.startTemperature;
+
+  for (uint32_t step = 0; step < settings.stepCount; step++, temperature *= temperatureFactor)
+  {
+    ///
+    /// Swap two letters, or change one
+    ///
+    SBoardEdit edits[2];
+    SBoardEdit reverts[2];
+    uint32_t editCount = 1;
+
+    const uint32_t cell = uint32_t(random() % cellCount);
+    const uint32_t otherCell = uint32_t(random() % cellCount);
+
+    if ((random() & 1) && board[cell] != board[otherCell])
+    {
+      edits[0] = { cell % settings.width, cell / settings.width, board[otherCell] };
+      edits[1] = { otherCell % settings.width, otherCell / settings.width, board[cell] };
+      editCount = 2;
+    }
+    else
+    {
+      char letter = getRandomLetter();
+      while (letter == board[cell])
+      {
+        letter = getRandomLetter();
+      }
+
+      edits[0] = { cell % settings.width, cell / settings.width, letter };
+    }
+
+    for (uint32_t i = 0; i < editCount; i++)
+    {
+      char& boardLetter = board[edits[i].y * settings.width + edits[i].x];
+
+      reverts[i] = { edits[i].x, edits[i].y, boardLetter };
+      boardLetter = edits[i].letter;
+    }
+
+    const uint32_t newScore = pIncrementalRuntime
+      ? pIncrementalRuntime->ApplyEditsForScore(edits, editCount)
+      : pRuntime->FindScore(board.data(), settings.width, settings.height);
+
+    result.evaluatedBoardCount++;
+
+    const bool isAccepted
+      = newScore >= currentScore
+      || (temperature > 0 && getRandomUnit() < std::exp((double(newScore) - double(currentScore)) / temperature));
+
+    if (!isAccepted)
+    {
+      for (uint32_t i = 0; i < editCount; i++)
+      {
+        board[reverts[i].y * settings.width + reverts[i].x] = reverts[i].letter;
+      }
+
+      if (pIncrementalRuntime)
+      {
+        pIncrementalRuntime->UndoEdits();
+      }
+
+      continue;
+    }
+
+    currentScore = newScore;
+
+    if (currentScore > result.score)
+    {
+      result.board = board;
+      result.score = currentScore;
+    }
+  }
+
+  return result;
+}
+
+
+std::unique_ptr<boggle_game::CRuntime_TriePoolOptimized> boggle_game::CBoardOptimizer::CreateChainRuntime(const SSettings& settings) const
+{
+  std::unique_ptr<CRuntime_TriePoolOptimized> result;
+
+  if (IsScoringIncrementally(settings))
+  {
+    result = std::make_unique<CRuntime_Incremental>();
+  }
+  else if ((settings.width == 4 && settings.height == 4) || (settings.width == 5 && settings.height == 5))
+  {
+    result = std::make_unique<CRuntime_FixedBoard>();
+  }
+  else if (settings.width * settings.height <= CRuntime_Bitboard::C_MAX_CELL_COUNT)
+  {
+    result = std::make_unique<CRuntime_Bitboard>();
+  }
+  else
+  {
+    result = std::make_unique<CRuntime_TriePoolOptimized>();
+  }
+
+  result->AttachTrieRoot(m_dictionaryRuntime.GetTrieRoot());
+
+  return result;
+}
+
+
+bool boggle_game::CBoardOptimizer::IsScoringIncrementally(const SSettings& settings)
+{
+  ///
+  /// Where a change can reach every path, or the bitboard fits, searching
+  /// the whole board is faster than counting the paths
+  ///
+  return settings.scoring == EScoring::Incremental
+    && !CRuntime_Incremental::IsReachingWholeBoard(settings.width, settings.height)
+    && settings.width * settings.height > CRuntime_Bitboard::C_MAX_CELL_COUNT;
+}
+
+
+uint64_t boggle_game::CBoardOptimizer::GetChainSeed(const uint64_t seed, const uint32_t chain)
+{
+  ///
+  /// SplitMix64 of the two, so neighbouring seeds and chains still get
+  /// unrelated random numbers
+  ///
+  uint64_t result = seed + (uint64_t(chain) + 1) * 0x9e3779b97f4a7c15ull;
+
+  result = (result ^ (result >> 30)) * 0xbf58476d1ce4e5b9ull;
+  result = (result ^ (result >> 27)) * 0x94d049bb133111ebull;
+
+  return result ^ (result >> 31);
+}
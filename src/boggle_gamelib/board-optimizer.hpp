@@ -0,0 +1,99 @@
+#pragma once
+
+///
+/// Searches for boards with a high score, by simulated annealing
+///
+
+// ----------------------------------------------------------------------------
+
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+// ----------------------------------------------------------------------------
+
+
+namespace boggle_game
+{
+  class CRuntime_TriePoolOptimized;
+
+
+  class CBoardOptimizer
+  {
+  public:
+
+    enum class EScoring
+    {
+      /// Every board is solved from scratch, for its score only
+      Full,
+
+      /// Only the paths through the changed cells are counted again, and a
+      /// rejected board is taken back without searching. That only pays off
+      /// on boards wider or higher than a word is long, so smaller ones are
+      /// scored in full either way.
+      Incremental,
+    };
+
+    struct SSettings
+    {
+      uint32_t width = 4;
+      uint32_t height = 4;
+
+      /// Independent chains, each starting from a random board of its own.
+      /// They're spread over <threadCount> threads, which doesn't change the
+      /// result in any way.
+      uint32_t chainCount = 1;
+      uint32_t threadCount = 1;
+
+      /// Boards tried by each chain, after the one it starts with
+      uint32_t stepCount = 10000;
+
+      /// Chain n is seeded from <seed> and n only, so the same settings always
+      /// end up with the same board
+      uint64_t seed = 1;
+
+      /// A worse board is taken with a chance of exp(-scoreLoss / temperature),
+      /// and the temperature falls geometrically from start to end over the
+      /// steps of a chain. With a start temperature of 0 only boards at least
+      /// as good are taken, which is plain hill climbing.
+      double startTemperature = 8.0;
+      double endTemperature = 0.25;
+
+      EScoring scoring = EScoring::Full;
+    };
+
+    struct SResult
+    {
+      std::vector<char> board;
+      uint32_t score = 0;
+
+      /// Boards scored, over all chains
+      uint64_t evaluatedBoardCount = 0;
+    };
+
+    /// <dictionaryRuntime> must have its dictionary loaded. Every chain gets a
+    /// runtime of its own, sharing the same tries.
+    explicit CBoardOptimizer(const CRuntime_TriePoolOptimized& dictionaryRuntime);
+
+    SResult Optimize(const SSettings& settings) const;
+
+  private:
+    static const uint32_t C_LETTER_COUNT = ('z' - 'a') + 1;
+
+    /// Best board found by chain <chain>
+    SResult RunChain(const SSettings& settings, const uint32_t chain) const;
+
+    /// The fastest runtime for boards of <settings>
+    std::unique_ptr<CRuntime_TriePoolOptimized> CreateChainRuntime(const SSettings& settings) const;
+
+    /// True if the chains of <settings> use CRuntime_Incremental
+    static bool IsScoringIncrementally(const SSettings& settings);
+
+    static uint64_t GetChainSeed(const uint64_t seed, const uint32_t chain);
+
+  private:
+    const CRuntime_TriePoolOptimized& m_dictionaryRuntime;
+  };
+}
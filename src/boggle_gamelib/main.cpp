@@ -1,55 +1,91 @@
-#include "runtime_simple.hpp"
-#include "runtime_trie.hpp"
-#include "runtime_trie-pool.hpp"
-#include "runtime_trie-pool-optimized.hpp"
-#include "runtime_trie-threaded.hpp"
-
-#include <include/runtimefactory.hpp>
-
-#include <memory>
-
-
-// ----------------------------------------------------------------------------
-
-
-std::unique_ptr<boggle_game::IRuntime> boggle_game::CreateRuntimeSolver(const EBoggleSolver solver)
-{
-  switch (solver)
-  {
-    case EBoggleSolver::Simple:
-    {
-      return std::make_unique<CRuntime_Simple>();
-    }
-
-    case EBoggleSolver::Trie:
-    {
-      return std::make_unique<CRuntime_Trie>();
-    }
-
-    case EBoggleSolver::TriePool:
-    {
-      return std::make_unique<CRuntime_TriePool>();
-    }
-
-    case EBoggleSolver::TriePoolOptimized:
-    {
-      return std::make_unique<CRuntime_TriePoolOptimized>();
-    }
-
-    case EBoggleSolver::TrieThreaded:
-    {
-      return std::make_unique<CRuntime_TrieThreaded>();
-    }
-
-    default:
-    {
-      assert(false && "Missing case");
-      break;
-    }
-  }
-
-  return nullptr;
-}
-
-
-// ----------------------------------------------------------------------------
+#include "runtime_bitboard.hpp"
+#include "runtime_dawg.hpp"
+#include "runtime_fixed-board.hpp"
+#include "runtime_incremental.hpp"
+#include "runtime_simple.hpp"
+#include "runtime_trie.hpp"
+#include "runtime_trie-compact.hpp"
+#include "runtime_trie-parallel.hpp"
+#include "runtime_trie-pool.hpp"
+#include "runtime_trie-pool-optimized.hpp"
+#include "runtime_trie-threaded.hpp"
+
+#include <include/runtimefactory.hpp>
+
+#include <memory>
+
+
+// ----------------------------------------------------------------------------
+
+
+std::unique_ptr<boggle_game::IRuntime> boggle_game::CreateRuntimeSolver(const EBoggleSolver solver)
+{
+  switch (solver)
+  {
+    case EBoggleSolver::Simple:
+    {
+      return std::make_unique<CRuntime_Simple>();
+    }
+
+    case EBoggleSolver::Trie:
+    {
+      return std::make_unique<CRuntime_Trie>();
+    }
+
+    case EBoggleSolver::TriePool:
+    {
+      return std::make_unique<CRuntime_TriePool>();
+    }
+
+    case EBoggleSolver::TriePoolOptimized:
+    {
+      return std::make_unique<CRuntime_TriePoolOptimized>();
+    }
+
+    case EBoggleSolver::TrieThreaded:
+    {
+      return std::make_unique<CRuntime_TrieThreaded>();
+    }
+
+    case EBoggleSolver::TrieCompact:
+    {
+      return std::make_unique<CRuntime_TrieCompact>();
+    }
+
+    case EBoggleSolver::Dawg:
+    {
+      return std::make_unique<CRuntime_Dawg>();
+    }
+
+    case EBoggleSolver::TrieParallel:
+    {
+      return std::make_unique<CRuntime_TrieParallel>();
+    }
+
+    case EBoggleSolver::FixedBoard:
+    {
+      return std::make_unique<CRuntime_FixedBoard>();
+    }
+
+    case EBoggleSolver::Bitboard:
+    {
+      return std::make_unique<CRuntime_Bitboard>();
+    }
+
+    case EBoggleSolver::Incremental:
+    {
+      return std::make_unique<CRuntime_Incremental>();
+    }
+
+    default:
+    {
+      assert(false && "Missing case");
+      break;
+    }
+  }
+
+  return nullptr;
+}
+
+
+// ----------------------------------------------------------------------------
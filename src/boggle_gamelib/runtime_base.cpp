@@ -1 +1 @@
-#include "runtime_base.hpp"
+#include "runtime_base.hpp"
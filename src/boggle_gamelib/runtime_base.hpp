@@ -1,115 +1,160 @@
-#pragma once
-
-///
-/// Interface for a runtime of the Boggle game
-///
-
-// ----------------------------------------------------------------------------
-
-
-#include <include/iruntime.hpp>
-
-#include <cassert>
-#include <cstdint>
-#include <vector>
-
-
-// ----------------------------------------------------------------------------
-
-
-namespace boggle_game
-{
-  class CRuntime_Base : public IRuntime
-  {
-  public:
-
-    CRuntime_Base() {}
-    virtual ~CRuntime_Base() {}
-
-    void SetBoardLetter(const uint32_t x, const uint32_t y, const char newLetter);
-    char GetBoardLetter(const uint32_t x, const uint32_t y) const;
-
-    static uint32_t GetScoreForWordLength(const size_t wordLength);
-
-  protected:
-    void InitializeBoard(const char* pBoard, uint32_t width, uint32_t height);
-
-  protected:
-    std::vector<char> m_currentBoard;
-    uint32_t m_currentBoardWidth = 0;
-    uint32_t m_currentBoardHeight = 0;
-  };
-}
-
-
-// ----------------------------------------------------------------------------
-
-
-inline void boggle_game::CRuntime_Base::SetBoardLetter(const uint32_t x, const uint32_t y, const char newLetter)
-{
-  assert(!m_currentBoard.empty());
-  assert(x < m_currentBoardWidth);
-  assert(y < m_currentBoardHeight);
-
-  m_currentBoard[x + (y * m_currentBoardHeight)] = newLetter;
-}
-
-
-inline char boggle_game::CRuntime_Base::GetBoardLetter(const uint32_t x, const uint32_t y) const
-{
-  assert(!m_currentBoard.empty());
-  assert(x < m_currentBoardWidth);
-  assert(y < m_currentBoardHeight);
-
-  return m_currentBoard[x + (y * m_currentBoardHeight)];
-}
-
-
-// ----------------------------------------------------------------------------
-
-
-inline uint32_t boggle_game::CRuntime_Base::GetScoreForWordLength(const size_t wordLength)
-{
-  static const uint8_t s_scoreTable[C_MAX_WORD_LENGTH + 1] =
-  {
-    0,
-    0,
-    0,
-    1,    //< 3
-    1,    //< 4
-    2,    //< 5
-    3,    //< 6
-    5,    //< 7
-    11,   //< 8
-    11,
-    11,
-    11,
-    11,
-    11,
-    11,
-    11,
-  };
-
-  assert(wordLength >= 3 && "This should be checked for while loading the dictionary.");
-  assert(wordLength < sizeof(s_scoreTable) && "This should be checked for while loading the dictionary.");
-
-  return s_scoreTable[wordLength];
-}
-
-
-// ----------------------------------------------------------------------------
-
-
-inline void boggle_game::CRuntime_Base::InitializeBoard
-(
-  const char* pBoard,
-  uint32_t width,
-  uint32_t height
-)
-{
-  m_currentBoard.resize(width * height);
-  memcpy(m_currentBoard.data(), pBoard, m_currentBoard.size());
-
-  m_currentBoardWidth = width;
-  m_currentBoardHeight = height;
-}
+#pragma once
+
+///
+/// Interface for a runtime of the Boggle game
+///
+
+// ----------------------------------------------------------------------------
+
+
+#include <include/iruntime.hpp>
+
+#include <common/utils.hpp>
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+
+// ----------------------------------------------------------------------------
+
+
+namespace boggle_game
+{
+  static_assert(IRuntime::C_MIN_WORD_LENGTH == common::C_MIN_WORD_LENGTH && IRuntime::C_MAX_WORD_LENGTH == common::C_MAX_WORD_LENGTH, "The dictionary limits must match the score table");
+
+
+  class CRuntime_Base : public IRuntime
+  {
+  public:
+
+    CRuntime_Base() {}
+    virtual ~CRuntime_Base() {}
+
+    void SetBoardLetter(const uint32_t x, const uint32_t y, const char newLetter);
+    char GetBoardLetter(const uint32_t x, const uint32_t y) const;
+
+    static uint32_t GetScoreForWordLength(const size_t wordLength);
+
+  protected:
+    /// The board is stored with a border of C_SENTINEL cells around it, so
+    /// every board cell has all 8 neighbours in memory. A sentinel reads just
+    /// like a cell already on the current path, which the searches skip
+    /// anyway, so moving to a neighbour needs no edge detection at all.
+    static constexpr char C_SENTINEL = 0;
+
+    typedef std::array<ptrdiff_t, 8> NeighbourOffsets_t;
+
+    void InitializeBoard(const char* pBoard, uint32_t width, uint32_t height);
+
+    size_t GetBoardIndex(const uint32_t x, const uint32_t y) const;
+    void SetBoardLetter(const size_t index, const char newLetter);
+    char GetBoardLetter(const size_t index) const;
+
+  protected:
+    std::vector<char> m_currentBoard;
+    uint32_t m_currentBoardWidth = 0;
+    uint32_t m_currentBoardHeight = 0;
+    size_t m_currentBoardStride = 0;
+
+    /// Add one of these to a board index to get to a neighbour
+    NeighbourOffsets_t m_neighbourOffsets = {};
+  };
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+inline void boggle_game::CRuntime_Base::SetBoardLetter(const uint32_t x, const uint32_t y, const char newLetter)
+{
+  assert(!m_currentBoard.empty());
+  assert(x < m_currentBoardWidth);
+  assert(y < m_currentBoardHeight);
+
+  SetBoardLetter(GetBoardIndex(x, y), newLetter);
+}
+
+
+inline char boggle_game::CRuntime_Base::GetBoardLetter(const uint32_t x, const uint32_t y) const
+{
+  assert(!m_currentBoard.empty());
+  assert(x < m_currentBoardWidth);
+  assert(y < m_currentBoardHeight);
+
+  return GetBoardLetter(GetBoardIndex(x, y));
+}
+
+
+inline size_t boggle_game::CRuntime_Base::GetBoardIndex(const uint32_t x, const uint32_t y) const
+{
+  return (size_t(y) + 1) * m_currentBoardStride + (size_t(x) + 1);
+}
+
+
+inline void boggle_game::CRuntime_Base::SetBoardLetter(const size_t index, const char newLetter)
+{
+  assert(index < m_currentBoard.size());
+
+  m_currentBoard[index] = newLetter;
+}
+
+
+inline char boggle_game::CRuntime_Base::GetBoardLetter(const size_t index) const
+{
+  assert(index < m_currentBoard.size());
+
+  return m_currentBoard[index];
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+inline uint32_t boggle_game::CRuntime_Base::GetScoreForWordLength(const size_t wordLength)
+{
+  return common::GetScoreForWordLength(wordLength);
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+inline void boggle_game::CRuntime_Base::InitializeBoard
+(
+  const char* pBoard,
+  uint32_t width,
+  uint32_t height
+)
+{
+  m_currentBoardWidth = width;
+  m_currentBoardHeight = height;
+  m_currentBoardStride = size_t(width) + 2;
+
+  m_currentBoard.assign(m_currentBoardStride * (size_t(height) + 2), C_SENTINEL);
+
+  for (uint32_t y = 0; y < height; y++)
+  {
+    memcpy(&m_currentBoard[GetBoardIndex(0, y)], pBoard + (size_t(y) * width), width);
+  }
+
+  ///
+  /// Same order as the direction tables used elsewhere
+  ///
+  const ptrdiff_t stride = static_cast<ptrdiff_t>(m_currentBoardStride);
+
+  m_neighbourOffsets =
+  {
+    -1,
+    -stride - 1,
+    -stride,
+    -stride + 1,
+    1,
+    stride + 1,
+    stride,
+    stride - 1,
+  };
+}
@@ -0,0 +1,193 @@
+#include "runtime_bitboard.hpp"
+
+#include <common/utils.hpp>
+
+#include <cassert>
+
+
+// ----------------------------------------------------------------------------
+
+
+boggle_game::CRuntime_Bitboard::CRuntime_Bitboard()
+{
+}
+
+
+boggle_game::CRuntime_Bitboard::~CRuntime_Bitboard()
+{
+}
+
+
+boggle_game::SBoggleResults boggle_game::CRuntime_Bitboard::FindWords(
+  const char* pBoard,
+  uint32_t width,
+  uint32_t height)
+{
+  if (uint64_t(width) * height > C_MAX_CELL_COUNT)
+  {
+    return CRuntime_TriePoolOptimized::FindWords(pBoard, width, height);
+  }
+
+  return GetResults(SearchBitboard(pBoard, width, height));
+}
+
+
+uint32_t boggle_game::CRuntime_Bitboard::FindScore(
+  const char* pBoard,
+  uint32_t width,
+  uint32_t height)
+{
+  if (uint64_t(width) * height > C_MAX_CELL_COUNT)
+  {
+    return CRuntime_TriePoolOptimized::FindScore(pBoard, width, height);
+  }
+
+  SearchBitboard(pBoard, width, height);
+
+  return GetFoundScore();
+}
+
+
+uint32_t boggle_game::CRuntime_Bitboard::SearchBitboard(const char* pBoard, uint32_t width, uint32_t height)
+{
+  assert(m_pTrie);
+
+  InitializeBitboard(pBoard, width, height);
+
+  m_searchContext.Reset();
+  m_searchContext.Prepare(common::CTriePoolOptimized::GetAllocatedTrieCount());
+
+  for (uint32_t cell = 0; cell < m_bitboardCellCount; cell++)
+  {
+    /// Nothing left to look for once every word of the dictionary is found
+    if (m_pTrie->GetRemainingWords(m_searchContext) <= 0)
+    {
+      break;
+    }
+
+    const common::CTriePoolOptimized::LetterIndex_t letterAsIndex = m_cellLetters[cell];
+
+    if (!(m_pTrie->GetChildMask() & (1u << letterAsIndex)))
+    {
+      continue;
+    }
+
+    const common::CTriePoolOptimized::Index_t foundTrie = m_pTrie->FindTrieWithStartingLetter(letterAsIndex, m_searchContext);
+
+    DoSearchForWordsAtBoardLocation(cell, 0, *common::CTriePoolOptimized::GetPtrFromIndex(foundTrie));
+  }
+
+  return m_searchContext.GetFoundWordCount();
+}
+
+
+void boggle_game::CRuntime_Bitboard::InitializeNeighbourCellMasks(uint32_t width, uint32_t height)
+{
+  assert(uint64_t(width) * height <= C_MAX_CELL_COUNT);
+
+  if (width == m_bitboardWidth && height == m_bitboardHeight)
+  {
+    return;
+  }
+
+  m_bitboardWidth = width;
+  m_bitboardHeight = height;
+  m_bitboardCellCount = width * height;
+
+  for (uint32_t y = 0; y < height; y++)
+  {
+    for (uint32_t x = 0; x < width; x++)
+    {
+      uint64_t neighbourMask = 0;
+
+      for (uint32_t neighbourY = (y ? y - 1 : 0); neighbourY <= y + 1 && neighbourY < height; neighbourY++)
+      {
+        for (uint32_t neighbourX = (x ? x - 1 : 0); neighbourX <= x + 1 && neighbourX < width; neighbourX++)
+        {
+          if (neighbourX != x || neighbourY != y)
+          {
+            neighbourMask |= uint64_t(1) << (neighbourY * width + neighbourX);
+          }
+        }
+      }
+
+      m_neighbourCellMasks[y * width + x] = neighbourMask;
+    }
+  }
+}
+
+
+void boggle_game::CRuntime_Bitboard::InitializeBitboard(const char* pBoard, uint32_t width, uint32_t height)
+{
+  InitializeNeighbourCellMasks(width, height);
+
+  const uint32_t cellCount = m_bitboardCellCount;
+
+  m_letterCellMasks.fill(0);
+
+  for (uint32_t cell = 0; cell < cellCount; cell++)
+  {
+    m_cellLetters[cell] = common::CTriePoolOptimized::GetLetterAsIndex(pBoard[cell]);
+    m_letterCellMasks[m_cellLetters[cell]] |= uint64_t(1) << cell;
+  }
+
+  for (uint32_t cell = 0; cell < cellCount; cell++)
+  {
+    uint32_t letterMask = 0;
+
+    for (uint64_t neighbourMask = m_neighbourCellMasks[cell]; neighbourMask; neighbourMask &= neighbourMask - 1)
+    {
+      letterMask |= 1u << m_cellLetters[common::CountTrailingZeros(neighbourMask)];
+    }
+
+    m_neighbourLetterMasks[cell] = letterMask;
+  }
+}
+
+
+void boggle_game::CRuntime_Bitboard::DoSearchForWordsAtBoardLocation(
+  const uint32_t cell,
+  const uint64_t visitedMask,
+  const common::CTriePoolOptimized& currentTrie
+)
+{
+  if (currentTrie.GetRemainingWords(m_searchContext) <= 0)
+  {
+    return;
+  }
+
+  const uint64_t currentVisitedMask = visitedMask | (uint64_t(1) << cell);
+  const uint64_t freeNeighbourMask = m_neighbourCellMasks[cell] & ~currentVisitedMask;
+
+  ///
+  /// Go by letter rather than by neighbour: the cells that continue the path
+  /// with a letter are the ones next to this cell, holding that letter and
+  /// not on the path yet, which is one AND of three masks. The trie is only
+  /// looked up once per letter, however many cells hold it.
+  ///
+  for (uint32_t letterMask = currentTrie.GetChildMask() & m_neighbourLetterMasks[cell]; letterMask; letterMask &= letterMask - 1)
+  {
+    const common::CTriePoolOptimized::LetterIndex_t letterAsIndex = common::CTriePoolOptimized::LetterIndex_t(common::CountTrailingZeros(letterMask));
+
+    uint64_t nextCellMask = freeNeighbourMask & m_letterCellMasks[letterAsIndex];
+
+    if (!nextCellMask)
+    {
+      continue;
+    }
+
+    const common::CTriePoolOptimized::Index_t foundTrie = currentTrie.FindTrieWithStartingLetter(letterAsIndex, m_searchContext);
+    const common::CTriePoolOptimized& nextTrie = *common::CTriePoolOptimized::GetPtrFromIndex(foundTrie);
+
+    /// Nothing below, so the word itself was all there was to find
+    if (!nextTrie.GetChildMask())
+    {
+      continue;
+    }
+
+    for (; nextCellMask; nextCellMask &= nextCellMask - 1)
+    {
+      DoSearchForWordsAtBoardLocation(common::CountTrailingZeros(nextCellMask), currentVisitedMask, nextTrie);
+    }
+  }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "runtime_trie-pool-optimized.hpp"
+
+#include <common/containers/trie-pool-optimized.hpp>
+
+#include <array>
+#include <cstdint>
+
+
+// ----------------------------------------------------------------------------
+
+
+namespace boggle_game
+{
+  /// Searches boards of up to 64 cells with the whole board in a handful of
+  /// 64 bit masks. Bigger boards use the generic search of the pool-optimized
+  /// trie instead.
+  class CRuntime_Bitboard : public CRuntime_TriePoolOptimized
+  {
+  public:
+
+    static const uint32_t C_MAX_CELL_COUNT = 64;
+
+    CRuntime_Bitboard();
+    virtual ~CRuntime_Bitboard();
+
+    virtual SBoggleResults FindWords(const char* board, uint32_t width, uint32_t height) override;
+    virtual uint32_t FindScore(const char* board, uint32_t width, uint32_t height) override;
+
+  private:
+    typedef std::array<uint64_t, C_MAX_CELL_COUNT> CellMasks_t;
+
+    /// Board must have no more than C_MAX_CELL_COUNT cells. Returns the number
+    /// of words found.
+    uint32_t SearchBitboard(const char* pBoard, uint32_t width, uint32_t height);
+
+    void InitializeNeighbourCellMasks(uint32_t width, uint32_t height);
+    void InitializeBitboard(const char* pBoard, uint32_t width, uint32_t height);
+
+    /// <currentTrie> is the trie of the path so far, which ends at <cell>.
+    /// The cells of the path are the ones in <visitedMask>, not counting
+    /// <cell> itself.
+    void DoSearchForWordsAtBoardLocation(
+      const uint32_t cell,
+      const uint64_t visitedMask,
+      const common::CTriePoolOptimized& currentTrie
+    );
+
+  private:
+    uint32_t m_bitboardWidth = 0;
+    uint32_t m_bitboardHeight = 0;
+    uint32_t m_bitboardCellCount = 0;
+
+    /// Only depend on the size of the board, so they're kept until it changes
+    CellMasks_t m_neighbourCellMasks = {};
+
+    /// Per letter, the cells holding it
+    std::array<uint64_t, common::CTriePoolOptimized::C_CHILDREN_COUNT> m_letterCellMasks = {};
+
+    /// Per cell, the letters of its neighbours as a mask of letter indices
+    std::array<uint32_t, C_MAX_CELL_COUNT> m_neighbourLetterMasks = {};
+
+    std::array<common::CTriePoolOptimized::LetterIndex_t, C_MAX_CELL_COUNT> m_cellLetters = {};
+  };
+}
@@ -0,0 +1,132 @@
+#include "runtime_dawg.hpp"
+
+#include <common/io/dictionary-reader.hpp>
+#include <common/utils.hpp>
+
+#include <iostream>
+
+
+// ----------------------------------------------------------------------------
+
+
+boggle_game::CRuntime_Dawg::CRuntime_Dawg()
+{
+  m_dawg.Build();
+}
+
+
+boggle_game::CRuntime_Dawg::~CRuntime_Dawg()
+{
+}
+
+
+void boggle_game::CRuntime_Dawg::LoadDictionary(const char* path)
+{
+  m_searchContext.Reset();
+  m_dawg.Clear();
+
+
+  const bool loaded = common::ForEachDictionaryWord(path, C_MIN_WORD_LENGTH, C_MAX_WORD_LENGTH,
+    [this](const std::string_view currentWord)
+    {
+      m_dawg.AddWord(currentWord);
+    });
+
+  if (!loaded)
+  {
+    std::cout << "Couldn't open dictionary: " << path << std::endl;
+  }
+
+  m_dawg.Build();
+}
+
+
+boggle_game::SBoggleResults boggle_game::CRuntime_Dawg::FindWords(
+  const char* pBoard,
+  uint32_t width,
+  uint32_t height)
+{
+  InitializeBoard(pBoard, width, height);
+
+  m_searchContext.Reset();
+  m_searchContext.Prepare(m_dawg);
+
+  ///
+  /// Check every fields in a linear fashion ...
+  ///
+
+  for (uint32_t y = 0; y < height; y++)
+  {
+    /// Stop as soon as every word of the dictionary is found
+    if (m_searchContext.GetFoundWords().size() == m_dawg.GetWordCount())
+    {
+      break;
+    }
+
+    for (uint32_t x = 0; x < width; x++)
+    {
+      DoSearchForWordsAtBoardLocation(GetBoardIndex(x, y), { common::CDawg::C_ROOT, 0 });
+    }
+  }
+
+
+  ///
+  /// Provide the result struct. The context already knows exactly which
+  /// words were found, so there's no need to walk the graph.
+  ///
+  const auto& foundWords = m_searchContext.GetFoundWords();
+
+  SBoggleResults result;
+  result.words.reserve(foundWords.size());
+
+  for (const common::CDawg::WordId_t word : foundWords)
+  {
+    result.words.push_back(m_dawg.GetWord(word));
+    result.score += m_dawg.GetWordScore(word);
+  }
+
+  return result;
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void boggle_game::CRuntime_Dawg::DoSearchForWordsAtBoardLocation(
+  const size_t cell,
+  const common::CDawg::SState& currentState
+)
+{
+  const char currentBoardLetter = GetBoardLetter(cell);
+
+  if (!currentBoardLetter)
+  {
+    return;
+  }
+
+  const common::CDawg::LetterIndex_t letterAsIndex = common::CDawg::GetLetterAsIndex(currentBoardLetter);
+
+  common::CDawg::SState foundState;
+
+  if (!m_dawg.FindTrieWithStartingLetter(currentState, letterAsIndex, foundState, m_searchContext))
+  {
+    return;
+  }
+
+  if (m_dawg.GetRemainingWords(foundState, m_searchContext) > 0)
+  {
+    ///
+    /// Check all directions for a match. There's no need for edge detection,
+    /// as the border around the board is made up of sentinels.
+    ///
+
+    SetBoardLetter(cell, char(0));
+
+    for (const ptrdiff_t offset : m_neighbourOffsets)
+    {
+      DoSearchForWordsAtBoardLocation(cell + offset, foundState);
+    }
+
+    SetBoardLetter(cell, currentBoardLetter);
+  }
+}
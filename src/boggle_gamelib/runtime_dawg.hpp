@@ -0,0 +1,40 @@
+#pragma once
+
+#include "runtime_base.hpp"
+
+#include <common/containers/dawg.hpp>
+
+#include <cassert>
+
+
+// ----------------------------------------------------------------------------
+
+
+namespace boggle_game
+{
+  class CRuntime_Dawg : public CRuntime_Base
+  {
+  public:
+
+    CRuntime_Dawg();
+    virtual ~CRuntime_Dawg();
+
+    virtual void LoadDictionary(const char* path) override;
+    virtual SBoggleResults FindWords(const char* board, uint32_t width, uint32_t height) override;
+
+  private:
+    void DoSearchForWordsAtBoardLocation(
+      const size_t cell,
+      const common::CDawg::SState& currentState
+    );
+
+  private:
+    common::CDawg m_dawg;
+
+    /// Per search state, so the graph can be reused for any number of boards
+    common::CDawgSearchContext m_searchContext;
+  };
+}
+
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,77 @@
+#include "runtime_fixed-board.hpp"
+
+
+// ----------------------------------------------------------------------------
+
+
+boggle_game::CRuntime_FixedBoard::CRuntime_FixedBoard()
+{
+}
+
+
+boggle_game::CRuntime_FixedBoard::~CRuntime_FixedBoard()
+{
+}
+
+
+boggle_game::SBoggleResults boggle_game::CRuntime_FixedBoard::FindWords(
+  const char* pBoard,
+  uint32_t width,
+  uint32_t height)
+{
+  uint32_t foundWordCount = 0;
+
+  if (!SearchFixedBoard(pBoard, width, height, foundWordCount))
+  {
+    return CRuntime_TriePoolOptimized::FindWords(pBoard, width, height);
+  }
+
+  return GetResults(foundWordCount);
+}
+
+
+uint32_t boggle_game::CRuntime_FixedBoard::FindScore(
+  const char* pBoard,
+  uint32_t width,
+  uint32_t height)
+{
+  uint32_t foundWordCount = 0;
+
+  if (!SearchFixedBoard(pBoard, width, height, foundWordCount))
+  {
+    return CRuntime_TriePoolOptimized::FindScore(pBoard, width, height);
+  }
+
+  return GetFoundScore();
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+bool boggle_game::CRuntime_FixedBoard::SearchFixedBoard(
+  const char* pBoard,
+  uint32_t width,
+  uint32_t height,
+  uint32_t& foundWordCountOut)
+{
+  ///
+  /// Only the sizes actually played get a solver of their own, as each one is
+  /// compiled separately
+  ///
+  if (width == 4 && height == 4)
+  {
+    foundWordCountOut = SearchFixedBoard<4, 4>(pBoard);
+
+    return true;
+  }
+
+  if (width == 5 && height == 5)
+  {
+    foundWordCountOut = SearchFixedBoard<5, 5>(pBoard);
+
+    return true;
+  }
+
+  return false;
+}
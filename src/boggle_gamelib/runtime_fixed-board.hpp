@@ -0,0 +1,212 @@
+#pragma once
+
+#include "runtime_trie-pool-optimized.hpp"
+
+#include <common/containers/trie-pool-optimized.hpp>
+#include <common/utils.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+
+
+// ----------------------------------------------------------------------------
+
+
+namespace boggle_game
+{
+  /// Searches boards of exactly TWidth x THeight cells. Everything that
+  /// depends on the size of the board, like which cells are next to each
+  /// other or how deep a path can go, is worked out while compiling.
+  template <uint32_t TWidth, uint32_t THeight>
+  class TFixedBoardSolver
+  {
+  public:
+
+    static constexpr uint32_t C_CELL_COUNT = TWidth * THeight;
+
+    static_assert(C_CELL_COUNT > 0, "Empty boards have nothing to search");
+    static_assert(C_CELL_COUNT <= 32, "The cells of the current path are kept in a 32 bit mask");
+
+    /// Mark every word on <pBoard> in <context>, and return how many words
+    /// were found
+    static uint32_t FindWords(
+      const char* pBoard,
+      const common::CTriePoolOptimized& root,
+      common::CTriePoolOptimizedSearchContext& context
+    );
+
+  private:
+    typedef std::array<uint32_t, C_CELL_COUNT> NeighbourMasks_t;
+    typedef std::array<common::CTriePoolOptimized::LetterIndex_t, C_CELL_COUNT> Board_t;
+
+    /// A path can't be longer than a word, nor visit a cell twice
+    static constexpr uint32_t C_MAX_PATH_LENGTH = std::min<uint32_t>(common::CTriePoolOptimized::C_MAX_WORD_LENGTH, C_CELL_COUNT);
+
+    static constexpr NeighbourMasks_t GetNeighbourMasks();
+
+    /// Bit n of an entry is set if cell n is next to the entry's cell
+    static constexpr NeighbourMasks_t C_NEIGHBOUR_MASKS = GetNeighbourMasks();
+
+    /// <TPathLength> cells, the ones in <visitedMask>, are on the path so far
+    template <uint32_t TPathLength>
+    static void DoSearchForWordsAtBoardLocation(
+      const Board_t& board,
+      const uint32_t cell,
+      const uint32_t visitedMask,
+      const common::CTriePoolOptimized& currentTrie,
+      common::CTriePoolOptimizedSearchContext& context
+    );
+  };
+
+
+  // ----------------------------------------------------------------------------
+
+
+  /// Solves the common small board sizes with a TFixedBoardSolver, and any
+  /// other size with the generic search of the pool-optimized trie
+  class CRuntime_FixedBoard : public CRuntime_TriePoolOptimized
+  {
+  public:
+
+    CRuntime_FixedBoard();
+    virtual ~CRuntime_FixedBoard();
+
+    virtual SBoggleResults FindWords(const char* board, uint32_t width, uint32_t height) override;
+    virtual uint32_t FindScore(const char* board, uint32_t width, uint32_t height) override;
+
+  protected:
+    /// Returns false if there's no fixed-size solver for the board, and
+    /// otherwise the number of words found in <foundWordCountOut>
+    bool SearchFixedBoard(const char* board, uint32_t width, uint32_t height, uint32_t& foundWordCountOut);
+
+  private:
+    template <uint32_t TWidth, uint32_t THeight>
+    uint32_t SearchFixedBoard(const char* board);
+  };
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+template <uint32_t TWidth, uint32_t THeight>
+inline uint32_t boggle_game::TFixedBoardSolver<TWidth, THeight>::FindWords(
+  const char* pBoard,
+  const common::CTriePoolOptimized& root,
+  common::CTriePoolOptimizedSearchContext& context
+)
+{
+  Board_t board;
+
+  for (uint32_t cell = 0; cell < C_CELL_COUNT; cell++)
+  {
+    board[cell] = common::CTriePoolOptimized::GetLetterAsIndex(pBoard[cell]);
+  }
+
+  for (uint32_t cell = 0; cell < C_CELL_COUNT; cell++)
+  {
+    /// Nothing left to look for once every word of the dictionary is found
+    if (root.GetRemainingWords(context) <= 0)
+    {
+      break;
+    }
+
+    DoSearchForWordsAtBoardLocation<0>(board, cell, 0, root, context);
+  }
+
+  return context.GetFoundWordCount();
+}
+
+
+template <uint32_t TWidth, uint32_t THeight>
+constexpr typename boggle_game::TFixedBoardSolver<TWidth, THeight>::NeighbourMasks_t boggle_game::TFixedBoardSolver<TWidth, THeight>::GetNeighbourMasks()
+{
+  NeighbourMasks_t result = {};
+
+  for (uint32_t y = 0; y < THeight; y++)
+  {
+    for (uint32_t x = 0; x < TWidth; x++)
+    {
+      uint32_t neighbourMask = 0;
+
+      for (uint32_t neighbourY = (y ? y - 1 : 0); neighbourY <= y + 1 && neighbourY < THeight; neighbourY++)
+      {
+        for (uint32_t neighbourX = (x ? x - 1 : 0); neighbourX <= x + 1 && neighbourX < TWidth; neighbourX++)
+        {
+          if (neighbourX != x || neighbourY != y)
+          {
+            neighbourMask |= 1u << (neighbourY * TWidth + neighbourX);
+          }
+        }
+      }
+
+      result[y * TWidth + x] = neighbourMask;
+    }
+  }
+
+  return result;
+}
+
+
+template <uint32_t TWidth, uint32_t THeight>
+template <uint32_t TPathLength>
+inline void boggle_game::TFixedBoardSolver<TWidth, THeight>::DoSearchForWordsAtBoardLocation(
+  const Board_t& board,
+  const uint32_t cell,
+  const uint32_t visitedMask,
+  const common::CTriePoolOptimized& currentTrie,
+  common::CTriePoolOptimizedSearchContext& context
+)
+{
+  const common::CTriePoolOptimized::LetterIndex_t letterAsIndex = board[cell];
+
+  if (!(currentTrie.GetChildMask() & (1u << letterAsIndex)))
+  {
+    return;
+  }
+
+  const common::CTriePoolOptimized::Index_t foundTrie = currentTrie.FindTrieWithStartingLetter(letterAsIndex, context);
+
+  ///
+  /// The deepest call is known while compiling, so the one for the last cell
+  /// of the longest path doesn't even have the code to go any further
+  ///
+  if constexpr (TPathLength + 1 < C_MAX_PATH_LENGTH)
+  {
+    const common::CTriePoolOptimized* pFoundTrie = common::CTriePoolOptimized::GetPtrFromIndex(foundTrie);
+
+    if (pFoundTrie->GetRemainingWords(context) <= 0)
+    {
+      return;
+    }
+
+    const uint32_t currentVisitedMask = visitedMask | (1u << cell);
+
+    for (uint32_t neighbourMask = C_NEIGHBOUR_MASKS[cell] & ~currentVisitedMask; neighbourMask; neighbourMask &= neighbourMask - 1)
+    {
+      DoSearchForWordsAtBoardLocation<TPathLength + 1>(
+        board,
+        common::CountTrailingZeros(neighbourMask),
+        currentVisitedMask,
+        *pFoundTrie,
+        context);
+    }
+  }
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+template <uint32_t TWidth, uint32_t THeight>
+inline uint32_t boggle_game::CRuntime_FixedBoard::SearchFixedBoard(const char* board)
+{
+  assert(m_pTrie);
+
+  m_searchContext.Reset();
+  m_searchContext.Prepare(common::CTriePoolOptimized::GetAllocatedTrieCount());
+
+  return TFixedBoardSolver<TWidth, THeight>::FindWords(board, *m_pTrie, m_searchContext);
+}
@@ -0,0 +1,567 @@
+#include "runtime_incremental.hpp"
+
+#include <common/utils.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+
+// ----------------------------------------------------------------------------
+
+
+boggle_game::CRuntime_Incremental::CRuntime_Incremental()
+{
+}
+
+
+boggle_game::CRuntime_Incremental::~CRuntime_Incremental()
+{
+}
+
+
+void boggle_game::CRuntime_Incremental::LoadDictionary(const char* path)
+{
+  CRuntime_TriePoolOptimized::LoadDictionary(path);
+
+  m_trieHeights.clear();
+}
+
+
+bool boggle_game::CRuntime_Incremental::LoadCompiledDictionary(const char* path)
+{
+  m_trieHeights.clear();
+
+  return CRuntime_TriePoolOptimized::LoadCompiledDictionary(path);
+}
+
+
+boggle_game::SBoggleResults boggle_game::CRuntime_Incremental::FindWords(
+  const char* pBoard,
+  uint32_t width,
+  uint32_t height)
+{
+  assert(m_pTrie);
+
+  ClearPresentTries();
+
+  const uint32_t trieCount = common::CTriePoolOptimized::GetAllocatedTrieCount();
+
+  ///
+  /// The heights are worked out on the first board, so they're right for a
+  /// root that was attached rather than loaded as well
+  ///
+  if (m_trieHeights.size() != trieCount || m_trieHeightsRoot != GetTrieRoot())
+  {
+    m_trieHeights.assign(trieCount, 0);
+    m_trieHeightsRoot = GetTrieRoot();
+
+    PrepareTrieHeights(m_trieHeightsRoot);
+  }
+
+  m_occurrenceCounts.resize(trieCount, 0);
+  m_presentTriePositions.resize(trieCount, C_NO_POSITION);
+  m_changedFlags.resize(trieCount, 0);
+
+  InitializeBoard(pBoard, width, height);
+
+  m_board.assign(pBoard, pBoard + (size_t(width) * height));
+  m_cellFlags.assign(m_currentBoard.size(), 0);
+  m_editDistances.assign(m_currentBoard.size(), C_FAR_FROM_EDIT);
+
+  m_occurrenceChanges.clear();
+  m_undoEdits.clear();
+
+  ///
+  /// Every edit will reach the whole board, so the paths are never counted
+  ///
+  if (IsReachingWholeBoard(m_currentBoardWidth, m_currentBoardHeight))
+  {
+    ResolveBoard(nullptr);
+  }
+  else
+  {
+    CountAllOccurrences();
+  }
+
+  return GetCurrentResults();
+}
+
+
+boggle_game::SBoggleResultsDiff boggle_game::CRuntime_Incremental::ApplyEdits(const SBoardEdit* pEdits, const uint32_t count)
+{
+  assert(m_pTrie);
+  assert(!m_currentBoard.empty() && "FindWords must be called first");
+
+  for (uint32_t i = 0; i < count; i++)
+  {
+    assert(pEdits[i].x < m_currentBoardWidth);
+    assert(pEdits[i].y < m_currentBoardHeight);
+    assert(pEdits[i].letter >= 'a' && pEdits[i].letter <= 'z' && "Only a to z, as 0 marks the board edges");
+  }
+
+  SBoggleResultsDiff result;
+
+  /// The diff needs the words from before the edits
+  if (m_arePresentTriesStale)
+  {
+    ResolveBoard(nullptr);
+  }
+
+  m_occurrenceChanges.clear();
+
+  ///
+  /// When every path could reach an edit, searching them all again with the
+  /// fast search beats counting them
+  ///
+  if (IsReachingWholeBoard(m_currentBoardWidth, m_currentBoardHeight) || !MarkStartCells(pEdits, count))
+  {
+    SetEditLetters(pEdits, count);
+    ResolveBoard(&result);
+  }
+  else
+  {
+    CountEditedPaths(pEdits, count);
+    UpdatePresentTries(&result);
+  }
+
+  ClearStartCells();
+
+  result.score = m_currentScore;
+
+  return result;
+}
+
+
+uint32_t boggle_game::CRuntime_Incremental::ApplyEditsForScore(const SBoardEdit* pEdits, const uint32_t count)
+{
+  assert(m_pTrie);
+  assert(!m_currentBoard.empty() && "FindWords must be called first");
+
+  for (uint32_t i = 0; i < count; i++)
+  {
+    assert(pEdits[i].x < m_currentBoardWidth);
+    assert(pEdits[i].y < m_currentBoardHeight);
+    assert(pEdits[i].letter >= 'a' && pEdits[i].letter <= 'z' && "Only a to z, as 0 marks the board edges");
+  }
+
+  m_occurrenceChanges.clear();
+  m_undoScore = m_currentScore;
+
+  if (IsReachingWholeBoard(m_currentBoardWidth, m_currentBoardHeight) || !MarkStartCells(pEdits, count))
+  {
+    SetEditLetters(pEdits, count);
+    ResolveScore();
+  }
+  else
+  {
+    CountEditedPaths(pEdits, count);
+    UpdatePresentTries(nullptr);
+  }
+
+  ClearStartCells();
+
+  return m_currentScore;
+}
+
+
+void boggle_game::CRuntime_Incremental::UndoEdits()
+{
+  ///
+  /// Each trie is in the journal once, so the order doesn't matter. Only
+  /// the words whose count comes back from 0 or goes back to 0 change.
+  ///
+  for (const SOccurrenceChange& change : m_occurrenceChanges)
+  {
+    uint32_t& occurrenceCount = m_occurrenceCounts[change.trie];
+
+    if (!occurrenceCount && change.previousCount)
+    {
+      AddPresentTrie(change.trie);
+    }
+    else if (occurrenceCount && !change.previousCount)
+    {
+      RemovePresentTrie(change.trie);
+    }
+
+    occurrenceCount = change.previousCount;
+  }
+
+  m_occurrenceChanges.clear();
+
+  ///
+  /// Backwards, in case a cell was edited more than once
+  ///
+  for (size_t i = m_undoEdits.size(); i-- > 0; )
+  {
+    const SBoardEdit& undoEdit = m_undoEdits[i];
+
+    SetBoardLetter(undoEdit.x, undoEdit.y, undoEdit.letter);
+    m_board[(size_t(undoEdit.y) * m_currentBoardWidth) + undoEdit.x] = undoEdit.letter;
+  }
+
+  m_undoEdits.clear();
+
+  m_currentScore = m_undoScore;
+}
+
+
+boggle_game::SBoggleResults boggle_game::CRuntime_Incremental::GetCurrentResults()
+{
+  if (m_arePresentTriesStale)
+  {
+    ResolveBoard(nullptr);
+  }
+
+  SBoggleResults result;
+  result.words.reserve(m_presentTries.size());
+
+  for (const common::CTriePoolOptimized::Index_t trie : m_presentTries)
+  {
+    result.words.push_back(GetTrieWord(trie));
+  }
+
+  result.score = m_currentScore;
+
+  return result;
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void boggle_game::CRuntime_Incremental::ResolveBoard(SBoggleResultsDiff* pDiffOut)
+{
+  uint32_t foundWordCount = 0;
+
+  if (!SearchFixedBoard(m_board.data(), m_currentBoardWidth, m_currentBoardHeight, foundWordCount))
+  {
+    FindWordsAndStandbyForWordRetrieving(m_board.data(), m_currentBoardWidth, m_currentBoardHeight);
+  }
+
+  ///
+  /// Backwards, as removing one moves the last trie into its place
+  ///
+  for (size_t i = m_presentTries.size(); i-- > 0; )
+  {
+    const common::CTriePoolOptimized::Index_t trie = m_presentTries[i];
+
+    if (!m_searchContext.IsFound(trie))
+    {
+      m_occurrenceCounts[trie] = 0;
+
+      RemovePresentTrie(trie);
+
+      if (pDiffOut)
+      {
+        pDiffOut->removedWords.push_back(GetTrieWord(trie));
+      }
+    }
+  }
+
+  for (const common::CTriePoolOptimized::Index_t trie : m_searchContext.GetFoundTries())
+  {
+    if (m_presentTriePositions[trie] == C_NO_POSITION)
+    {
+      AddPresentTrie(trie);
+
+      if (pDiffOut)
+      {
+        pDiffOut->addedWords.push_back(GetTrieWord(trie));
+      }
+    }
+  }
+
+  m_areOccurrencesCounted = false;
+  m_arePresentTriesStale = false;
+}
+
+
+void boggle_game::CRuntime_Incremental::ResolveScore()
+{
+  m_currentScore = CRuntime_FixedBoard::FindScore(m_board.data(), m_currentBoardWidth, m_currentBoardHeight);
+
+  m_areOccurrencesCounted = false;
+  m_arePresentTriesStale = true;
+}
+
+
+void boggle_game::CRuntime_Incremental::SetEditLetters(const SBoardEdit* pEdits, const uint32_t count)
+{
+  m_undoEdits.clear();
+
+  for (uint32_t i = 0; i < count; i++)
+  {
+    m_undoEdits.push_back({ pEdits[i].x, pEdits[i].y, GetBoardLetter(GetBoardIndex(pEdits[i].x, pEdits[i].y)) });
+
+    SetBoardLetter(pEdits[i].x, pEdits[i].y, pEdits[i].letter);
+    m_board[(size_t(pEdits[i].y) * m_currentBoardWidth) + pEdits[i].x] = pEdits[i].letter;
+  }
+}
+
+
+void boggle_game::CRuntime_Incremental::CountAllOccurrences()
+{
+  ClearPresentTries();
+
+  ///
+  /// Count every path, as if the whole board was just edited
+  ///
+  for (uint32_t y = 0; y < m_currentBoardHeight; y++)
+  {
+    for (uint32_t x = 0; x < m_currentBoardWidth; x++)
+    {
+      CountWordsAtBoardLocation(GetBoardIndex(x, y), 1, true, *m_pTrie, 1);
+    }
+  }
+
+  UpdatePresentTries(nullptr);
+
+  m_occurrenceChanges.clear();
+  m_areOccurrencesCounted = true;
+  m_arePresentTriesStale = false;
+}
+
+
+bool boggle_game::CRuntime_Incremental::MarkStartCells(const SBoardEdit* pEdits, const uint32_t count)
+{
+  for (uint32_t i = 0; i < count; i++)
+  {
+    const SBoardEdit& edit = pEdits[i];
+
+    m_cellFlags[GetBoardIndex(edit.x, edit.y)] |= CELL_EDITED;
+
+    const uint32_t endX = std::min(edit.x + C_REACH, m_currentBoardWidth - 1);
+    const uint32_t endY = std::min(edit.y + C_REACH, m_currentBoardHeight - 1);
+
+    for (uint32_t y = (edit.y > C_REACH) ? edit.y - C_REACH : 0; y <= endY; y++)
+    {
+      for (uint32_t x = (edit.x > C_REACH) ? edit.x - C_REACH : 0; x <= endX; x++)
+      {
+        const size_t cell = GetBoardIndex(x, y);
+        uint8_t& cellFlags = m_cellFlags[cell];
+
+        if (!(cellFlags & CELL_START))
+        {
+          cellFlags |= CELL_START;
+          m_startCells.push_back({ x, y });
+        }
+
+        const uint32_t distanceX = (x > edit.x) ? x - edit.x : edit.x - x;
+        const uint32_t distanceY = (y > edit.y) ? y - edit.y : edit.y - y;
+
+        m_editDistances[cell] = std::min<uint8_t>(m_editDistances[cell], uint8_t(std::max(distanceX, distanceY)));
+      }
+    }
+  }
+
+  return m_startCells.size() < size_t(m_currentBoardWidth) * m_currentBoardHeight;
+}
+
+
+void boggle_game::CRuntime_Incremental::ClearStartCells()
+{
+  for (const SCell& startCell : m_startCells)
+  {
+    const size_t cell = GetBoardIndex(startCell.x, startCell.y);
+
+    m_cellFlags[cell] = 0;
+    m_editDistances[cell] = C_FAR_FROM_EDIT;
+  }
+
+  m_startCells.clear();
+}
+
+
+void boggle_game::CRuntime_Incremental::CountEditedPaths(const SBoardEdit* pEdits, const uint32_t count)
+{
+  if (!m_areOccurrencesCounted)
+  {
+    CountAllOccurrences();
+  }
+
+  ///
+  /// Take away the paths through the old letters, and add the ones through
+  /// the new letters. Any other path stays just as it was.
+  ///
+  for (const SCell& startCell : m_startCells)
+  {
+    CountWordsAtBoardLocation(GetBoardIndex(startCell.x, startCell.y), 1, false, *m_pTrie, -1);
+  }
+
+  SetEditLetters(pEdits, count);
+
+  for (const SCell& startCell : m_startCells)
+  {
+    CountWordsAtBoardLocation(GetBoardIndex(startCell.x, startCell.y), 1, false, *m_pTrie, 1);
+  }
+}
+
+
+void boggle_game::CRuntime_Incremental::ClearPresentTries()
+{
+  for (const common::CTriePoolOptimized::Index_t trie : m_presentTries)
+  {
+    m_occurrenceCounts[trie] = 0;
+    m_presentTriePositions[trie] = C_NO_POSITION;
+  }
+
+  m_presentTries.clear();
+  m_currentScore = 0;
+}
+
+
+void boggle_game::CRuntime_Incremental::CountWordsAtBoardLocation(
+  const size_t cell,
+  const uint32_t pathLength,
+  const bool isTouchingEdit,
+  const common::CTriePoolOptimized& currentTrie,
+  const int32_t occurrenceChange
+)
+{
+  const char currentBoardLetter = GetBoardLetter(cell);
+
+  /// A sentinel, or a cell already on the path
+  if (!currentBoardLetter)
+  {
+    return;
+  }
+
+  const common::CTriePoolOptimized::Index_t foundTrie = currentTrie.GetChild(common::CTriePoolOptimized::GetLetterAsIndex(currentBoardLetter));
+
+  if (!foundTrie)
+  {
+    return;
+  }
+
+  const bool isNowTouchingEdit = isTouchingEdit || (m_cellFlags[cell] & CELL_EDITED);
+
+  /// Leave paths whose words all end before they could reach an edit, as
+  /// they stay the same
+  if (!isNowTouchingEdit && m_editDistances[cell] > m_trieHeights[foundTrie])
+  {
+    return;
+  }
+
+  const common::CTriePoolOptimized* pFoundTrie = common::CTriePoolOptimized::GetPtrFromIndex(foundTrie);
+
+  if (isNowTouchingEdit && pFoundTrie->GetWordId())
+  {
+    ChangeOccurrences(foundTrie, occurrenceChange);
+  }
+
+  if (!pFoundTrie->GetChildMask() || pathLength == C_MAX_WORD_LENGTH)
+  {
+    return;
+  }
+
+  SetBoardLetter(cell, char(0));
+
+  for (const ptrdiff_t offset : m_neighbourOffsets)
+  {
+    CountWordsAtBoardLocation(cell + offset, pathLength + 1, isNowTouchingEdit, *pFoundTrie, occurrenceChange);
+  }
+
+  SetBoardLetter(cell, currentBoardLetter);
+}
+
+
+uint8_t boggle_game::CRuntime_Incremental::PrepareTrieHeights(const common::CTriePoolOptimized::Index_t trie)
+{
+  const common::CTriePoolOptimized* pTrie = common::CTriePoolOptimized::GetPtrFromIndex(trie);
+
+  uint8_t height = 0;
+
+  for (uint32_t childMask = pTrie->GetChildMask(); childMask; childMask &= childMask - 1)
+  {
+    const common::CTriePoolOptimized::LetterIndex_t letterAsIndex = common::CTriePoolOptimized::LetterIndex_t(common::CountTrailingZeros(childMask));
+
+    height = std::max<uint8_t>(height, PrepareTrieHeights(pTrie->GetChild(letterAsIndex)) + 1);
+  }
+
+  m_trieHeights[trie] = height;
+
+  return height;
+}
+
+
+void boggle_game::CRuntime_Incremental::ChangeOccurrences(const common::CTriePoolOptimized::Index_t trie, const int32_t occurrenceChange)
+{
+  uint32_t& occurrenceCount = m_occurrenceCounts[trie];
+
+  if (!m_changedFlags[trie])
+  {
+    m_changedFlags[trie] = 1;
+    m_occurrenceChanges.push_back({ trie, occurrenceCount });
+  }
+
+  assert(occurrenceChange > 0 || occurrenceCount);
+
+  occurrenceCount += occurrenceChange;
+}
+
+
+void boggle_game::CRuntime_Incremental::UpdatePresentTries(SBoggleResultsDiff* pDiffOut)
+{
+  ///
+  /// A word that went away with the old paths and came back with the new
+  /// ones was there all along, so only the counts before and after matter
+  ///
+  for (const SOccurrenceChange& change : m_occurrenceChanges)
+  {
+    m_changedFlags[change.trie] = 0;
+
+    const uint32_t occurrenceCount = m_occurrenceCounts[change.trie];
+
+    if (occurrenceCount && !change.previousCount)
+    {
+      AddPresentTrie(change.trie);
+
+      if (pDiffOut)
+      {
+        pDiffOut->addedWords.push_back(GetTrieWord(change.trie));
+      }
+    }
+    else if (!occurrenceCount && change.previousCount)
+    {
+      RemovePresentTrie(change.trie);
+
+      if (pDiffOut)
+      {
+        pDiffOut->removedWords.push_back(GetTrieWord(change.trie));
+      }
+    }
+  }
+}
+
+
+void boggle_game::CRuntime_Incremental::AddPresentTrie(const common::CTriePoolOptimized::Index_t trie)
+{
+  assert(m_presentTriePositions[trie] == C_NO_POSITION);
+
+  m_presentTriePositions[trie] = uint32_t(m_presentTries.size());
+  m_presentTries.push_back(trie);
+
+  m_currentScore += GetScoreForWordLength(strlen(GetTrieWord(trie)));
+}
+
+
+void boggle_game::CRuntime_Incremental::RemovePresentTrie(const common::CTriePoolOptimized::Index_t trie)
+{
+  const uint32_t position = m_presentTriePositions[trie];
+
+  assert(position != C_NO_POSITION);
+
+  ///
+  /// Move the last one into the gap
+  ///
+  const common::CTriePoolOptimized::Index_t lastTrie = m_presentTries.back();
+
+  m_presentTries[position] = lastTrie;
+  m_presentTriePositions[lastTrie] = position;
+
+  m_presentTries.pop_back();
+  m_presentTriePositions[trie] = C_NO_POSITION;
+
+  m_currentScore -= GetScoreForWordLength(strlen(GetTrieWord(trie)));
+}
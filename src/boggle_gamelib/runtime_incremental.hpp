@@ -0,0 +1,224 @@
+#pragma once
+
+#include "runtime_fixed-board.hpp"
+
+#include <common/containers/trie-pool-optimized.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+// ----------------------------------------------------------------------------
+
+
+namespace boggle_game
+{
+  struct SBoardEdit
+  {
+    uint32_t x = 0;
+    uint32_t y = 0;
+    char letter = 0;
+  };
+
+
+  struct SBoggleResultsDiff
+  {
+    std::vector<const char*> addedWords;
+    std::vector<const char*> removedWords;
+
+    /// Score of the whole board after the edits
+    uint32_t score = 0;
+  };
+
+
+  // ----------------------------------------------------------------------------
+
+
+  /// Keeps the board and the words on it between calls, so that after a few
+  /// letters are changed only the paths through them have to be searched
+  /// again. Every word keeps a count of the paths spelling it, and it's gone
+  /// once the last of them is.
+  ///
+  /// On boards small enough for a path from anywhere to reach an edit, that
+  /// would be every path anyway. The board is then solved again with the
+  /// fast search instead, and the words diffed against the previous ones.
+  class CRuntime_Incremental : public CRuntime_FixedBoard
+  {
+  public:
+
+    CRuntime_Incremental();
+    virtual ~CRuntime_Incremental();
+
+    virtual void LoadDictionary(const char* path) override;
+    virtual bool LoadCompiledDictionary(const char* path) override;
+
+    /// Solves the board from scratch, and keeps it for ApplyEdits
+    virtual SBoggleResults FindWords(const char* board, uint32_t width, uint32_t height) override;
+
+    /// Change the letters of the board given to FindWords, and return the
+    /// words this adds and removes. The board must only be changed this way,
+    /// not with SetBoardLetter.
+    SBoggleResultsDiff ApplyEdits(const SBoardEdit* pEdits, const uint32_t count);
+
+    /// Same as ApplyEdits, but only the score of the board is returned. Once
+    /// the first board is set up, nothing is allocated.
+    uint32_t ApplyEditsForScore(const SBoardEdit* pEdits, const uint32_t count);
+
+    /// Take back the edits of the last ApplyEditsForScore, without searching
+    /// the board again
+    void UndoEdits();
+
+    /// All words on the board as it is now
+    SBoggleResults GetCurrentResults();
+
+    /// True if a path reaching any cell could start anywhere on a board of
+    /// <width> x <height>. Edits on such a board solve all of it again.
+    static bool IsReachingWholeBoard(const uint32_t width, const uint32_t height);
+
+  private:
+    enum ECellFlags : uint8_t
+    {
+      CELL_EDITED = 1 << 0,
+      CELL_START = 1 << 1,
+    };
+
+    /// Solve the board again with the fast search, and move the words found
+    /// and no longer found into <pDiffOut>, if given. The path counts are
+    /// stale after.
+    void ResolveBoard(SBoggleResultsDiff* pDiffOut);
+
+    /// Only the score of ResolveBoard, leaving the words on the board stale
+    /// as well
+    void ResolveScore();
+
+    /// Change the letters of both board copies, keeping the old ones in
+    /// m_undoEdits
+    void SetEditLetters(const SBoardEdit* pEdits, const uint32_t count);
+
+    /// Mark the edited cells and every cell a path to them could start from.
+    /// Returns false if that's the whole board.
+    bool MarkStartCells(const SBoardEdit* pEdits, const uint32_t count);
+    void ClearStartCells();
+
+    /// Change the letters, and count the paths through them again
+    void CountEditedPaths(const SBoardEdit* pEdits, const uint32_t count);
+
+    /// Count every path of the board from scratch
+    void CountAllOccurrences();
+
+    /// Forget about the words on the board
+    void ClearPresentTries();
+
+    /// Count the paths through <pathLength> cells, ending at <cell>. Only
+    /// paths touching an edited cell are counted, unless <isTouchingEdit> is
+    /// set from the start.
+    void CountWordsAtBoardLocation(
+      const size_t cell,
+      const uint32_t pathLength,
+      const bool isTouchingEdit,
+      const common::CTriePoolOptimized& currentTrie,
+      const int32_t occurrenceChange
+    );
+
+    /// Returns the height of <trie>
+    uint8_t PrepareTrieHeights(const common::CTriePoolOptimized::Index_t trie);
+
+    /// Add <occurrenceChange> to the paths spelling the word of <trie>
+    void ChangeOccurrences(const common::CTriePoolOptimized::Index_t trie, const int32_t occurrenceChange);
+
+    /// Add the words whose count went up from 0, and remove the ones whose
+    /// count went down to 0, into <pDiffOut> as well if given
+    void UpdatePresentTries(SBoggleResultsDiff* pDiffOut);
+
+    void AddPresentTrie(const common::CTriePoolOptimized::Index_t trie);
+    void RemovePresentTrie(const common::CTriePoolOptimized::Index_t trie);
+
+    static const char* GetTrieWord(const common::CTriePoolOptimized::Index_t trie);
+
+  private:
+    struct SCell
+    {
+      uint32_t x;
+      uint32_t y;
+    };
+
+    struct SOccurrenceChange
+    {
+      common::CTriePoolOptimized::Index_t trie;
+      uint32_t previousCount;
+    };
+
+    static constexpr uint32_t C_NO_POSITION = UINT32_MAX;
+
+    /// A path reaching an edited cell can't start any further away from it
+    /// than a word is long
+    static constexpr uint32_t C_REACH = C_MAX_WORD_LENGTH - 1;
+
+    /// Every cell further than C_REACH from an edit
+    static constexpr uint8_t C_FAR_FROM_EDIT = UINT8_MAX;
+
+    /// Per trie, how many more letters the longest word below it has. A path
+    /// can't go any further than that.
+    std::vector<uint8_t> m_trieHeights;
+    common::CTriePoolOptimized::Index_t m_trieHeightsRoot = 0;
+
+    /// Per trie, how many paths on the board spell its word
+    std::vector<uint32_t> m_occurrenceCounts;
+
+    /// Tries with a word on the board, and where in the list each trie is
+    std::vector<common::CTriePoolOptimized::Index_t> m_presentTries;
+    std::vector<uint32_t> m_presentTriePositions;
+
+    uint32_t m_currentScore = 0;
+
+    /// The board without its sentinels, as the fast searches read it
+    std::vector<char> m_board;
+
+    /// False once the board was solved again rather than counted, until the
+    /// paths are counted again
+    bool m_areOccurrencesCounted = false;
+
+    /// True once only the score was searched again, until the words are found
+    /// again as well
+    bool m_arePresentTriesStale = false;
+
+    /// Per board cell, a combination of ECellFlags. Only set during ApplyEdits.
+    std::vector<uint8_t> m_cellFlags;
+
+    /// Every cell close enough to an edit for a path from it to reach one
+    std::vector<SCell> m_startCells;
+
+    /// Per board cell, steps to the closest edited cell, or C_FAR_FROM_EDIT.
+    /// Only set for the start cells during ApplyEdits.
+    std::vector<uint8_t> m_editDistances;
+
+    ///
+    /// Every trie whose count changed with the last edits, with the count it
+    /// had before, so the edits can be taken back. m_changedFlags is set for
+    /// the tries in here until the words on the board are updated.
+    ///
+    std::vector<SOccurrenceChange> m_occurrenceChanges;
+    std::vector<uint8_t> m_changedFlags;
+
+    /// The letters the last edits replaced, and the score before them
+    std::vector<SBoardEdit> m_undoEdits;
+    uint32_t m_undoScore = 0;
+  };
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+inline const char* boggle_game::CRuntime_Incremental::GetTrieWord(const common::CTriePoolOptimized::Index_t trie)
+{
+  return common::CTriePoolOptimized::GetWord(common::CTriePoolOptimized::GetPtrFromIndex(trie)->GetWordId());
+}
+
+
+inline bool boggle_game::CRuntime_Incremental::IsReachingWholeBoard(const uint32_t width, const uint32_t height)
+{
+  return width <= C_REACH + 1 && height <= C_REACH + 1;
+}
@@ -0,0 +1,132 @@
+#include "runtime_trie-compact.hpp"
+
+#include <common/io/dictionary-reader.hpp>
+#include <common/utils.hpp>
+
+#include <iostream>
+
+
+// ----------------------------------------------------------------------------
+
+
+boggle_game::CRuntime_TrieCompact::CRuntime_TrieCompact()
+{
+  m_trie.Build();
+}
+
+
+boggle_game::CRuntime_TrieCompact::~CRuntime_TrieCompact()
+{
+}
+
+
+void boggle_game::CRuntime_TrieCompact::LoadDictionary(const char* path)
+{
+  m_searchContext.Reset();
+  m_trie.Clear();
+
+
+  const bool loaded = common::ForEachDictionaryWord(path, C_MIN_WORD_LENGTH, C_MAX_WORD_LENGTH,
+    [this](const std::string_view currentWord)
+    {
+      m_trie.AddWord(currentWord);
+    });
+
+  if (!loaded)
+  {
+    std::cout << "Couldn't open dictionary: " << path << std::endl;
+  }
+
+  m_trie.Build();
+}
+
+
+boggle_game::SBoggleResults boggle_game::CRuntime_TrieCompact::FindWords(
+  const char* pBoard,
+  uint32_t width,
+  uint32_t height)
+{
+  InitializeBoard(pBoard, width, height);
+
+  m_searchContext.Reset();
+  m_searchContext.Prepare(m_trie);
+
+  ///
+  /// Check every fields in a linear fashion ...
+  ///
+
+  for (uint32_t y = 0; y < height; y++)
+  {
+    /// Stop as soon as every word of the dictionary is found
+    if (m_searchContext.GetFoundWords().size() == m_trie.GetWordCount())
+    {
+      break;
+    }
+
+    for (uint32_t x = 0; x < width; x++)
+    {
+      DoSearchForWordsAtBoardLocation(GetBoardIndex(x, y), common::CTrieCompact::C_ROOT);
+    }
+  }
+
+
+  ///
+  /// Provide the result struct. The context already knows exactly which
+  /// words were found, so there's no need to walk the trie.
+  ///
+  const auto& foundWords = m_searchContext.GetFoundWords();
+
+  SBoggleResults result;
+  result.words.reserve(foundWords.size());
+
+  for (const common::CTrieCompact::WordId_t word : foundWords)
+  {
+    result.words.push_back(m_trie.GetWord(word));
+    result.score += m_trie.GetWordScore(word);
+  }
+
+  return result;
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void boggle_game::CRuntime_TrieCompact::DoSearchForWordsAtBoardLocation(
+  const size_t cell,
+  const common::CTrieCompact::Index_t currentTrie
+)
+{
+  const char currentBoardLetter = GetBoardLetter(cell);
+
+  if (!currentBoardLetter)
+  {
+    return;
+  }
+
+  const common::CTrieCompact::LetterIndex_t letterAsIndex = common::CTrieCompact::GetLetterAsIndex(currentBoardLetter);
+
+  const common::CTrieCompact::Index_t foundTrie = m_trie.FindTrieWithStartingLetter(currentTrie, letterAsIndex, m_searchContext);
+
+  if (foundTrie == common::CTrieCompact::C_NO_CHILD)
+  {
+    return;
+  }
+
+  if (m_trie.GetRemainingWords(foundTrie, m_searchContext) > 0)
+  {
+    ///
+    /// Check all directions for a match. There's no need for edge detection,
+    /// as the border around the board is made up of sentinels.
+    ///
+
+    SetBoardLetter(cell, char(0));
+
+    for (const ptrdiff_t offset : m_neighbourOffsets)
+    {
+      DoSearchForWordsAtBoardLocation(cell + offset, foundTrie);
+    }
+
+    SetBoardLetter(cell, currentBoardLetter);
+  }
+}
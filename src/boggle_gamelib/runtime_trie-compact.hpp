@@ -0,0 +1,40 @@
+#pragma once
+
+#include "runtime_base.hpp"
+
+#include <common/containers/trie-compact.hpp>
+
+#include <cassert>
+
+
+// ----------------------------------------------------------------------------
+
+
+namespace boggle_game
+{
+  class CRuntime_TrieCompact : public CRuntime_Base
+  {
+  public:
+
+    CRuntime_TrieCompact();
+    virtual ~CRuntime_TrieCompact();
+
+    virtual void LoadDictionary(const char* path) override;
+    virtual SBoggleResults FindWords(const char* board, uint32_t width, uint32_t height) override;
+
+  private:
+    void DoSearchForWordsAtBoardLocation(
+      const size_t cell,
+      const common::CTrieCompact::Index_t currentTrie
+    );
+
+  private:
+    common::CTrieCompact m_trie;
+
+    /// Per search state, so the trie can be reused for any number of boards
+    common::CTrieCompactSearchContext m_searchContext;
+  };
+}
+
+
+// ----------------------------------------------------------------------------
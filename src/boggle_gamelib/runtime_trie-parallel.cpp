@@ -0,0 +1,416 @@
+#include "runtime_trie-parallel.hpp"
+
+#include <common/io/dictionary-reader.hpp>
+#include <common/utils.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+
+// ----------------------------------------------------------------------------
+
+
+boggle_game::CRuntime_TrieParallel::CRuntime_TrieParallel(const uint32_t workerCount, const std::vector<uint32_t>& cpuAffinity)
+{
+  uint32_t currentWorkerCount = workerCount;
+
+  if (!currentWorkerCount)
+  {
+    currentWorkerCount = std::thread::hardware_concurrency();
+  }
+
+  if (!currentWorkerCount)
+  {
+    currentWorkerCount = 1;
+  }
+
+  m_workers.resize(currentWorkerCount);
+
+  m_threadPool.Start(currentWorkerCount - 1, cpuAffinity);
+
+  m_trie.Build();
+}
+
+
+boggle_game::CRuntime_TrieParallel::~CRuntime_TrieParallel()
+{
+  m_threadPool.Stop();
+}
+
+
+void boggle_game::CRuntime_TrieParallel::LoadDictionary(const char* path)
+{
+  m_searchContext.Reset();
+  m_trie.Clear();
+
+
+  const bool loaded = common::ForEachDictionaryWord(path, C_MIN_WORD_LENGTH, C_MAX_WORD_LENGTH,
+    [this](const std::string_view currentWord)
+    {
+      m_trie.AddWord(currentWord);
+    });
+
+  if (!loaded)
+  {
+    std::cout << "Couldn't open dictionary: " << path << std::endl;
+  }
+
+  m_trie.Build();
+
+
+  ///
+  /// Every child of every child of the root is a prefix task
+  ///
+  m_prefixTasks.clear();
+
+  const common::CTrieCompact::SNode& root = m_trie.GetNode(common::CTrieCompact::C_ROOT);
+
+  for (common::CTrieCompact::LetterIndex_t first = 0; first < common::CTrieCompact::C_CHILDREN_COUNT; first++)
+  {
+    const uint32_t firstBit = 1u << first;
+    if (!(root.childMask & firstBit))
+    {
+      continue;
+    }
+
+    const common::CTrieCompact::Index_t firstTrie = root.firstChild + common::PopCount(root.childMask & (firstBit - 1));
+    const common::CTrieCompact::SNode& firstNode = m_trie.GetNode(firstTrie);
+
+    for (common::CTrieCompact::LetterIndex_t second = 0; second < common::CTrieCompact::C_CHILDREN_COUNT; second++)
+    {
+      const uint32_t secondBit = 1u << second;
+      if (!(firstNode.childMask & secondBit))
+      {
+        continue;
+      }
+
+      const common::CTrieCompact::SNode& secondNode = m_trie.GetNode(firstNode.firstChild + common::PopCount(firstNode.childMask & (secondBit - 1)));
+
+      SPrefixTask task;
+      task.firstLetter = first;
+      task.secondLetter = second;
+      task.trie = firstTrie;
+      task.wordCount = secondNode.wordCount + ((secondNode.word != common::CTrieCompact::C_NO_WORD) ? 1 : 0);
+
+      m_prefixTasks.push_back(task);
+    }
+  }
+
+  std::stable_sort(m_prefixTasks.begin(), m_prefixTasks.end(),
+    [](const SPrefixTask& left, const SPrefixTask& right)
+    {
+      return left.wordCount > right.wordCount;
+    });
+
+  ///
+  /// Every worker starts out with a consecutive range of the tasks, and
+  /// works its way from the front. Dealing the tasks out like cards gives
+  /// every range its share of the heavy ones first, and leaves the light ones
+  /// at the back for stealing.
+  ///
+  const uint32_t workerCount = static_cast<uint32_t>(m_workers.size());
+  const uint32_t taskCount = static_cast<uint32_t>(m_prefixTasks.size());
+
+  m_prefixTaskOrder.clear();
+
+  for (uint32_t worker = 0; worker < workerCount; worker++)
+  {
+    for (uint32_t i = worker; i < taskCount; i += workerCount)
+    {
+      m_prefixTaskOrder.push_back(i);
+    }
+  }
+}
+
+
+void boggle_game::CRuntime_TrieParallel::SetTaskSplit(const ETaskSplit taskSplit)
+{
+  m_taskSplit = taskSplit;
+}
+
+
+boggle_game::CRuntime_TrieParallel::STiling boggle_game::CRuntime_TrieParallel::GetTiling(const uint32_t width, const uint32_t height)
+{
+  STiling result;
+  result.width = width;
+  result.height = height;
+
+  for (result.tileSize = C_TILE_SIZE; ; result.tileSize *= 2)
+  {
+    result.tileCountX = static_cast<uint32_t>((uint64_t(width) + result.tileSize - 1) / result.tileSize);
+    const uint64_t tileCountY = (uint64_t(height) + result.tileSize - 1) / result.tileSize;
+
+    const uint64_t tileCount = result.tileCountX * tileCountY;
+
+    if (tileCount <= UINT32_MAX)
+    {
+      result.tileCount = static_cast<uint32_t>(tileCount);
+      break;
+    }
+  }
+
+  return result;
+}
+
+
+boggle_game::SBoggleResults boggle_game::CRuntime_TrieParallel::FindWords(
+  const char* pBoard,
+  uint32_t width,
+  uint32_t height)
+{
+  return FindWords(pBoard, width, height, width);
+}
+
+
+boggle_game::SBoggleResults boggle_game::CRuntime_TrieParallel::FindWords(
+  const char* pBoard,
+  uint32_t width,
+  uint32_t height,
+  size_t stride)
+{
+  static_assert(C_MAX_WORD_LENGTH <= common::CVisitedWindow::C_RADIUS, "A path could leave the visited window");
+
+  const uint32_t workerCount = static_cast<uint32_t>(m_workers.size());
+
+  m_board = common::SBoardView(pBoard, width, height, stride);
+
+  m_searchContext.Prepare(m_trie, workerCount);
+
+  for (uint32_t i = 0; i < workerCount; i++)
+  {
+    m_workers[i].pSearchContext = &m_searchContext.GetWorker(i);
+  }
+
+  if (m_taskSplit == ETaskSplit::Tiles)
+  {
+    PrepareTiles();
+
+    m_threadPool.RunForEachIndex(workerCount, [this](const size_t workerIndex)
+    {
+      SearchTiles(static_cast<uint32_t>(workerIndex));
+    });
+  }
+  else
+  {
+    PreparePrefixes();
+
+    m_threadPool.RunForEachIndex(workerCount, [this](const size_t workerIndex)
+    {
+      SearchPrefixes(static_cast<uint32_t>(workerIndex));
+    });
+
+    for (auto& cells : m_letterCells)
+    {
+      cells.clear();
+    }
+  }
+
+  m_board = common::SBoardView();
+
+
+  ///
+  /// Provide the result struct. Every word was claimed by exactly one
+  /// worker, so the lists can just be joined.
+  ///
+  size_t foundWordsCount = 0;
+  for (uint32_t i = 0; i < workerCount; i++)
+  {
+    foundWordsCount += m_searchContext.GetWorker(i).GetFoundWords().size();
+  }
+
+  SBoggleResults result;
+  result.words.reserve(foundWordsCount);
+
+  for (uint32_t i = 0; i < workerCount; i++)
+  {
+    for (const common::CTrieCompact::WordId_t word : m_searchContext.GetWorker(i).GetFoundWords())
+    {
+      result.words.push_back(m_trie.GetWord(word));
+      result.score += m_trie.GetWordScore(word);
+    }
+  }
+
+  return result;
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void boggle_game::CRuntime_TrieParallel::PrepareTiles()
+{
+  m_tiling = GetTiling(m_board.width, m_board.height);
+
+  m_tasks.Initialize(static_cast<uint32_t>(m_workers.size()), m_tiling.tileCount);
+}
+
+
+void boggle_game::CRuntime_TrieParallel::PreparePrefixes()
+{
+  ///
+  /// Where every letter is, so a task only visits the cells of its first
+  /// letter rather than the whole board.
+  ///
+  for (uint32_t y = 0; y < m_board.height; y++)
+  {
+    for (uint32_t x = 0; x < m_board.width; x++)
+    {
+      const common::CTrieCompact::LetterIndex_t letterAsIndex = common::CTrieCompact::GetLetterAsIndex(m_board.GetLetter(x, y));
+
+      m_letterCells[letterAsIndex].push_back({ x, y });
+    }
+  }
+
+  m_tasks.Initialize(static_cast<uint32_t>(m_workers.size()), static_cast<uint32_t>(m_prefixTaskOrder.size()));
+}
+
+
+void boggle_game::CRuntime_TrieParallel::SearchTiles(const uint32_t workerIndex)
+{
+  SWorker& worker = m_workers[workerIndex];
+
+  uint32_t tile = 0;
+  while (m_tasks.Pop(workerIndex, tile))
+  {
+    /// Every word of the dictionary is found, so the remaining tiles can't
+    /// add anything
+    if (worker.pSearchContext->IsEverythingFound())
+    {
+      break;
+    }
+
+    uint32_t beginX, beginY, endX, endY;
+    m_tiling.GetTileBounds(tile, beginX, beginY, endX, endY);
+
+    for (uint32_t y = beginY; y < endY; y++)
+    {
+      for (uint32_t x = beginX; x < endX; x++)
+      {
+        worker.visited.Center(x, y);
+
+        DoSearchForWordsAtBoardLocation(worker, x, y, common::CTrieCompact::C_ROOT);
+      }
+    }
+  }
+}
+
+
+void boggle_game::CRuntime_TrieParallel::SearchPrefixes(const uint32_t workerIndex)
+{
+  SWorker& worker = m_workers[workerIndex];
+
+  uint32_t taskIndex = 0;
+  while (m_tasks.Pop(workerIndex, taskIndex))
+  {
+    const SPrefixTask& task = m_prefixTasks[m_prefixTaskOrder[taskIndex]];
+
+    for (const SCell& cell : m_letterCells[task.firstLetter])
+    {
+      if (worker.pSearchContext->IsEverythingFound())
+      {
+        return;
+      }
+
+      worker.visited.Center(cell.x, cell.y);
+      worker.visited.SetVisited(cell.x, cell.y);
+
+      for (int32_t offsetY = -1; offsetY <= 1; offsetY++)
+      {
+        for (int32_t offsetX = -1; offsetX <= 1; offsetX++)
+        {
+          const uint32_t currentX = cell.x + offsetX;
+          const uint32_t currentY = cell.y + offsetY;
+
+          /// Edge detection, just like in the search. The start cell itself
+          /// is marked as visited.
+          if (currentX >= m_board.width || currentY >= m_board.height)
+          {
+            continue;
+          }
+
+          if (m_board.GetLetter(currentX, currentY) != char('a' + task.secondLetter))
+          {
+            continue;
+          }
+
+          DoSearchForWordsAtBoardLocation(worker, currentX, currentY, task.trie);
+        }
+      }
+
+      worker.visited.ClearVisited(cell.x, cell.y);
+    }
+  }
+}
+
+
+void boggle_game::CRuntime_TrieParallel::DoSearchForWordsAtBoardLocation(
+  SWorker& worker,
+  const uint32_t x,
+  const uint32_t y,
+  const common::CTrieCompact::Index_t currentTrie
+)
+{
+  if (worker.visited.IsVisited(x, y))
+  {
+    return;
+  }
+
+  const char currentBoardLetter = m_board.GetLetter(x, y);
+
+  const common::CTrieCompact::LetterIndex_t letterAsIndex = common::CTrieCompact::GetLetterAsIndex(currentBoardLetter);
+
+  const common::CTrieCompact::Index_t foundTrie = m_trie.FindTrieWithStartingLetter(currentTrie, letterAsIndex, *worker.pSearchContext);
+
+  if (foundTrie == common::CTrieCompact::C_NO_CHILD)
+  {
+    return;
+  }
+
+  if (m_trie.GetRemainingWords(foundTrie, *worker.pSearchContext) > 0)
+  {
+    ///
+    /// Check all directions for a match
+    ///
+
+    enum Axis_t : uint8_t
+    {
+      X = 0,
+      Y = 1,
+      MAX
+    };
+    typedef int8_t Direction_t[Axis_t::MAX];
+
+    static const Direction_t s_directions[] =
+    {
+      { -1,  0 },
+      { -1, -1 },
+      { 0, -1 },
+      { 1, -1 },
+      { 1,  0 },
+      { 1,  1 },
+      { 0,  1 },
+      { -1,  1 },
+    };
+
+    worker.visited.SetVisited(x, y);
+
+    for (uint32_t i = 0; i < common::GetArrayLength(s_directions); i++)
+    {
+      const Direction_t& currentDirection = s_directions[i];
+      const uint32_t currentX = x + currentDirection[Axis_t::X];
+      const uint32_t currentY = y + currentDirection[Axis_t::Y];
+
+      /// Edge detection. Notice how minus values underflow, and as such we only
+      /// need to test for max, not minimum.
+      if (currentX >= m_board.width || currentY >= m_board.height)
+      {
+        continue;
+      }
+
+      DoSearchForWordsAtBoardLocation(worker, currentX, currentY, foundTrie);
+    }
+
+    worker.visited.ClearVisited(x, y);
+  }
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <include/iruntime.hpp>
+
+#include <common/containers/board-view.hpp>
+#include <common/containers/trie-compact.hpp>
+#include <common/threading/thread-pool.hpp>
+#include <common/threading/work-stealing-ranges.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+
+// ----------------------------------------------------------------------------
+
+
+namespace boggle_game
+{
+  /// All workers search a single shared trie, and the work is split into
+  /// tasks instead. Tasks are handed out with work stealing, so a worker never
+  /// idles while there are tasks left anywhere, and every word is claimed by
+  /// the first worker finding it.
+  class CRuntime_TrieParallel : public IRuntime
+  {
+  public:
+
+    enum class ETaskSplit
+    {
+      /// Tiles of start cells. Best for big boards.
+      Tiles,
+
+      /// The first two letters of the words, heaviest first. Evens out
+      /// dictionaries where a few prefixes hold most of the words, but every
+      /// task visits the cells of its first letter.
+      Prefixes,
+    };
+
+    /// <workerCount> of 0 uses one worker per hardware thread. The calling
+    /// thread acts as the first worker, and the others are kept parked in a
+    /// pool between the calls. If <cpuAffinity> isn't empty, the pooled
+    /// threads are pinned to those CPUs in turn.
+    CRuntime_TrieParallel(const uint32_t workerCount = 0, const std::vector<uint32_t>& cpuAffinity = {});
+    virtual ~CRuntime_TrieParallel();
+
+    virtual void LoadDictionary(const char* path) override;
+    virtual SBoggleResults FindWords(const char* board, uint32_t width, uint32_t height) override;
+
+    /// Same as above, for a board where rows are <stride> bytes apart. The
+    /// board is read in place, and must stay unchanged until the call returns.
+    SBoggleResults FindWords(const char* board, uint32_t width, uint32_t height, size_t stride);
+
+    void SetTaskSplit(const ETaskSplit taskSplit);
+
+    /// How the start cells of a board are split into tiles
+    struct STiling
+    {
+      uint32_t width = 0;
+      uint32_t height = 0;
+      uint32_t tileSize = 0;
+      uint32_t tileCountX = 0;
+      uint32_t tileCount = 0;
+
+      /// Start cells [beginX, endX) x [beginY, endY) of <tile>
+      void GetTileBounds(const uint32_t tile, uint32_t& beginXOut, uint32_t& beginYOut, uint32_t& endXOut, uint32_t& endYOut) const;
+    };
+
+    /// Tiles are numbered in 32 bits, so the tiles grow until a board of
+    /// <width> x <height> fits
+    static STiling GetTiling(const uint32_t width, const uint32_t height);
+
+  private:
+    typedef common::CTrieCompactSharedSearchContext::CWorker SearchContext_t;
+
+    struct SWorker
+    {
+      common::CVisitedWindow visited;
+      SearchContext_t* pSearchContext = nullptr;
+    };
+
+    struct SPrefixTask
+    {
+      common::CTrieCompact::LetterIndex_t firstLetter;
+      common::CTrieCompact::LetterIndex_t secondLetter;
+
+      /// Trie of the first letter
+      common::CTrieCompact::Index_t trie;
+
+      /// Words starting with the prefix
+      int32_t wordCount;
+    };
+
+    struct SCell
+    {
+      uint32_t x;
+      uint32_t y;
+    };
+
+    void PrepareTiles();
+    void PreparePrefixes();
+
+    void SearchTiles(const uint32_t workerIndex);
+    void SearchPrefixes(const uint32_t workerIndex);
+
+    void DoSearchForWordsAtBoardLocation(
+      SWorker& worker,
+      const uint32_t x,
+      const uint32_t y,
+      const common::CTrieCompact::Index_t currentTrie
+    );
+
+  private:
+    /// Tiles are C_TILE_SIZE x C_TILE_SIZE start cells. Small enough to give
+    /// every worker plenty of them, and big enough to keep the overhead of
+    /// taking one low. Boards with more than 2^32 tiles use bigger ones.
+    static const uint32_t C_TILE_SIZE = 16;
+
+    ETaskSplit m_taskSplit = ETaskSplit::Tiles;
+
+    common::CTrieCompact m_trie;
+
+    /// All prefixes of the dictionary, heaviest first, and the order the
+    /// workers take them in.
+    std::vector<SPrefixTask> m_prefixTasks;
+    std::vector<uint32_t> m_prefixTaskOrder;
+
+    common::CTrieCompactSharedSearchContext m_searchContext;
+    std::vector<SWorker> m_workers;
+
+    /// Only valid during a search
+    common::SBoardView m_board;
+    STiling m_tiling;
+    std::vector<SCell> m_letterCells[common::CTrieCompact::C_CHILDREN_COUNT];
+    common::CWorkStealingRanges m_tasks;
+
+    common::CThreadPool m_threadPool;
+  };
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+inline void boggle_game::CRuntime_TrieParallel::STiling::GetTileBounds(
+  const uint32_t tile,
+  uint32_t& beginXOut,
+  uint32_t& beginYOut,
+  uint32_t& endXOut,
+  uint32_t& endYOut) const
+{
+  assert(tile < tileCount);
+
+  beginXOut = (tile % tileCountX) * tileSize;
+  beginYOut = (tile / tileCountX) * tileSize;
+  endXOut = beginXOut + std::min(tileSize, width - beginXOut);
+  endYOut = beginYOut + std::min(tileSize, height - beginYOut);
+}
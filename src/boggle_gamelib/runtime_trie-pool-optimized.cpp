@@ -1,223 +1,532 @@
-#include "runtime_trie-pool-optimized.hpp"
-
-#include <common/utils.hpp>
-
-#include <fstream>
-#include <iostream>
-
-
-// ----------------------------------------------------------------------------
-
-
-boggle_game::CRuntime_TriePoolOptimized::CRuntime_TriePoolOptimized()
-{
-}
-
-
-boggle_game::CRuntime_TriePoolOptimized::~CRuntime_TriePoolOptimized()
-{
-}
-
-
-void boggle_game::CRuntime_TriePoolOptimized::LoadDictionary(const char* path)
-{
-  std::ifstream fileStream(path, std::ifstream::binary);
-  if (!fileStream)
-  {
-    std::cout << "Couldn't open dictionary: " << path << std::endl;
-    return;
-  }
-
-
-  common::CTriePoolOptimized::InitializePool();
-
-  InitializeTrieRoot();
-
-
-  std::string currentWord;
-  while ( std::getline(fileStream, currentWord) )
-  {
-    if (currentWord.empty())
-    {
-      continue;
-    }
-    
-    const char lastLetter = currentWord.at(currentWord.length() - 1);
-    
-    if (!isalpha(lastLetter))
-    {
-      currentWord.resize(currentWord.length() - 1);
-    }
-
-    /// According to the rules then a valid word must be 3 or more letters, so
-    /// start by eliminating words with less letters than that.
-    if (currentWord.length() < 3)
-    {
-      continue;
-    }
-
-    /// Our own limitation to optimize a lookup table.
-    if (currentWord.length() > C_MAX_WORD_LENGTH)
-    {
-      continue;
-    }
-
-    //std::transform(currentWord.begin(), currentWord.end(), currentWord.begin(), ::tolower);
-
-    m_pTrie->AddWord(currentWord);
-  }
-}
-
-
-boggle_game::SBoggleResults boggle_game::CRuntime_TriePoolOptimized::FindWords(
-  const char* pBoard,
-  uint32_t width,
-  uint32_t height)
-{
-  const uint32_t currentFoundWordsSize = FindWordsAndStandbyForWordRetrieving(pBoard, width, height);
-
-
-  ///
-  /// Provide the result struct ...
-  ///
-
-  
-  ///
-  /// Word list, which needs to be allocated just for this purpose
-  ///
-  SBoggleResults result;
-
-  if (currentFoundWordsSize)
-  {
-    result.words.resize(currentFoundWordsSize, nullptr);
-
-    common::TContainerWriter<const char*> containerWriter;
-    containerWriter.container = &result.words.at(0);
-
-    result.score = RetrieveWordsAndGetScore(containerWriter);
-  }
-
-
-  return result;
-}
-
-
-// ----------------------------------------------------------------------------
-
-
-void boggle_game::CRuntime_TriePoolOptimized::InitializeTrieRoot()
-{
-  assert(!m_pTrie);
-
-  m_pTrie = common::CTriePoolOptimized::GetPtrFromIndex(
-    common::CTriePoolOptimized::AllocateTrie());
-}
-
-
-uint32_t boggle_game::CRuntime_TriePoolOptimized::FindWordsAndStandbyForWordRetrieving(const char* board, unsigned width, unsigned height)
-{
-  InitializeBoard(board, width, height);
-
-  ///
-  /// Check every fields in a linear fashion ...
-  ///
-
-  for (uint32_t y = 0; y < height; y++)
-  {
-    for (uint32_t x = 0; x < width; x++)
-    {
-      DoSearchForWordsAtBoardLocation(x, y, *m_pTrie);
-    }
-  }
-
-  const uint32_t currentFoundWordsSize = common::CTriePoolOptimized::GetFoundWordsSize(*m_pTrie);
-
-  return currentFoundWordsSize;
-}
-
-
-uint32_t boggle_game::CRuntime_TriePoolOptimized::RetrieveWordsAndGetScore(common::TContainerWriter<const char*> output)
-{
-  uint32_t currentScore = 0;
-
-  common::CTriePoolOptimized::GetFoundWords(*m_pTrie, output, currentScore);
-
-  return currentScore;
-}
-
-
-// ----------------------------------------------------------------------------
-
-
-void boggle_game::CRuntime_TriePoolOptimized::DoSearchForWordsAtBoardLocation(
-  const uint32_t x,
-  const uint32_t y,
-  common::CTriePoolOptimized& currentTrie
-)
-{
-  const char currentBoardLetter = GetBoardLetter(x, y);
-
-  if (!currentBoardLetter)
-  {
-    return;
-  }
-
-  //TODO: Convert the entire board to this range
-  const common::CTriePoolOptimized::LetterIndex_t letterAsIndex = common::CTriePoolOptimized::GetLetterAsIndex(currentBoardLetter);
-
-  common::CTriePoolOptimized::Index_t foundTrie = currentTrie.FindTrieWithStartingLetter(letterAsIndex, currentTrie);
-
-  if (!foundTrie)
-  {
-    return;
-  }
-
-  common::CTriePoolOptimized* pFoundTrie = common::CTriePoolOptimized::GetPtrFromIndex(foundTrie);
-
-  if (pFoundTrie && pFoundTrie->GetRemainingWords() > 0)
-  {
-    ///
-    /// Check all directions for a match
-    ///
-
-    enum Axis_t : uint8_t
-    {
-      X = 0,
-      Y = 1,
-      MAX
-    };
-    typedef int8_t Direction_t[Axis_t::MAX];
-
-    static const Direction_t s_directions[] =
-    {
-      { -1,  0 },
-      { -1, -1 },
-      { 0, -1 },
-      { 1, -1 },
-      { 1,  0 },
-      { 1,  1 },
-      { 0,  1 },
-      { -1,  1 },
-    };
-
-    SetBoardLetter(x, y, char(0));
-
-    for (uint32_t i = 0; i < common::GetArrayLength(s_directions); i++)
-    {
-      const Direction_t& currentDirection = s_directions[i];
-      const uint32_t currentX = x + currentDirection[Axis_t::X];
-      const uint32_t currentY = y + currentDirection[Axis_t::Y];
-
-      /// Edge detection. Notice how minus values underflow, and as such we only
-      /// need to test for max, not minimum.
-      if (currentX >= m_currentBoardWidth || currentY >= m_currentBoardHeight)
-      {
-        continue;
-      }
-
-      DoSearchForWordsAtBoardLocation(currentX, currentY, *pFoundTrie);
-    }
-
-    SetBoardLetter(x, y, currentBoardLetter);
-  }
-}
+#include "runtime_trie-pool-optimized.hpp"
+
+#include <common/io/dictionary-reader.hpp>
+#include <common/utils.hpp>
+
+#include <iostream>
+
+
+// ----------------------------------------------------------------------------
+
+
+boggle_game::CRuntime_TriePoolOptimized::CRuntime_TriePoolOptimized()
+{
+}
+
+
+boggle_game::CRuntime_TriePoolOptimized::~CRuntime_TriePoolOptimized()
+{
+}
+
+
+void boggle_game::CRuntime_TriePoolOptimized::LoadDictionary(const char* path)
+{
+  common::CTriePoolOptimized::InitializePool();
+
+  InitializeTrieRoot();
+
+
+  const bool loaded = common::ForEachDictionaryWord(path, C_MIN_WORD_LENGTH, C_MAX_WORD_LENGTH,
+    [this](const std::string_view currentWord)
+    {
+      m_pTrie->AddWord(currentWord);
+    });
+
+  if (!loaded)
+  {
+    std::cout << "Couldn't open dictionary: " << path << std::endl;
+  }
+}
+
+
+boggle_game::SBoggleResults boggle_game::CRuntime_TriePoolOptimized::FindWords(
+  const char* pBoard,
+  uint32_t width,
+  uint32_t height)
+{
+  return GetResults(FindWordsAndStandbyForWordRetrieving(pBoard, width, height));
+}
+
+
+uint32_t boggle_game::CRuntime_TriePoolOptimized::FindScore(
+  const char* pBoard,
+  uint32_t width,
+  uint32_t height)
+{
+  FindWordsAndStandbyForWordRetrieving(pBoard, width, height);
+
+  return GetFoundScore();
+}
+
+
+bool boggle_game::CRuntime_TriePoolOptimized::SaveCompiledDictionary(const char* path) const
+{
+  assert(m_pTrie);
+
+  return common::CTriePoolOptimized::SaveCompiledDictionary(path, { GetTrieRoot() });
+}
+
+
+bool boggle_game::CRuntime_TriePoolOptimized::LoadCompiledDictionary(const char* path)
+{
+  m_pTrie = nullptr;
+
+  std::vector<common::CTriePoolOptimized::Index_t> roots;
+
+  if (!common::CTriePoolOptimized::LoadCompiledDictionary(path, roots) || roots.size() != 1)
+  {
+    std::cout << "Couldn't load compiled dictionary: " << path << std::endl;
+
+    common::CTriePoolOptimized::InitializePool();
+    InitializeTrieRoot();
+
+    return false;
+  }
+
+  AttachTrieRoot(roots[0]);
+
+  return true;
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void boggle_game::CRuntime_TriePoolOptimized::InitializeTrieRoot()
+{
+  assert(!m_pTrie);
+
+  m_pTrie = common::CTriePoolOptimized::GetPtrFromIndex(
+    common::CTriePoolOptimized::AllocateTrie());
+}
+
+
+void boggle_game::CRuntime_TriePoolOptimized::AttachTrieRoot(const common::CTriePoolOptimized::Index_t root)
+{
+  m_pTrie = common::CTriePoolOptimized::GetPtrFromIndex(root);
+}
+
+
+common::CTriePoolOptimized::Index_t boggle_game::CRuntime_TriePoolOptimized::GetTrieRoot() const
+{
+  return common::CTriePoolOptimized::GetIndexFromPtr(m_pTrie);
+}
+
+
+uint32_t boggle_game::CRuntime_TriePoolOptimized::FindWordsAndStandbyForWordRetrieving(const char* board, unsigned width, unsigned height)
+{
+  BeginSearch(board, width, height);
+
+  while (!ResumeSearch(UINT32_MAX))
+  {
+  }
+
+  return m_searchContext.GetFoundWordCount();
+}
+
+
+void boggle_game::CRuntime_TriePoolOptimized::BeginSearch(const char* board, unsigned width, unsigned height)
+{
+  InitializeBoard(board, width, height);
+
+  ///
+  /// Collect the letters around every cell, so the search can tell which
+  /// children of a trie are worth trying without looking at the neighbours
+  ///
+  m_neighbourLetterMasks.assign(m_currentBoard.size(), 0);
+
+  for (uint32_t y = 0; y < height; y++)
+  {
+    for (uint32_t x = 0; x < width; x++)
+    {
+      const size_t cell = GetBoardIndex(x, y);
+      uint32_t letterMask = 0;
+
+      for (const ptrdiff_t offset : m_neighbourOffsets)
+      {
+        const char neighbourLetter = GetBoardLetter(cell + offset);
+
+        if (neighbourLetter)
+        {
+          letterMask |= 1u << common::CTriePoolOptimized::GetLetterAsIndex(neighbourLetter);
+        }
+      }
+
+      m_neighbourLetterMasks[cell] = letterMask;
+    }
+  }
+
+  ///
+  /// Forget about the words found by any previous search. The trie itself
+  /// is never modified while searching, so there's no need to reload it.
+  ///
+  m_searchContext.Reset();
+  m_searchContext.Prepare(common::CTriePoolOptimized::GetAllocatedTrieCount());
+
+  PrefilterTries();
+
+  m_searchDepth = 0;
+  m_searchX = 0;
+  m_searchY = 0;
+}
+
+
+bool boggle_game::CRuntime_TriePoolOptimized::ResumeSearch(uint32_t maxSteps)
+{
+  ///
+  /// Depth first search, with the current path on an explicit stack instead
+  /// of the call stack. Every step tries to extend the path by one cell, so
+  /// the search can stop after any step and pick up from there later.
+  ///
+
+  for (; maxSteps > 0; maxSteps--)
+  {
+    size_t cell = 0;
+    const common::CTriePoolOptimized* pCurrentTrie = nullptr;
+    uint32_t candidateMask = 0;
+
+    if (!m_searchDepth)
+    {
+      ///
+      /// Start a new path, checking every fields in a linear fashion ...
+      ///
+      if (m_searchY >= m_currentBoardHeight || !m_currentBoardWidth)
+      {
+        return true;
+      }
+
+      /// Once every word of the dictionary is found, there's nothing left to
+      /// look for on the rest of the board
+      if (m_pTrie->GetRemainingWords(m_searchContext) <= 0)
+      {
+        m_searchY = m_currentBoardHeight;
+
+        return true;
+      }
+
+      cell = GetBoardIndex(m_searchX, m_searchY);
+      pCurrentTrie = m_pTrie;
+      candidateMask = GetSearchChildMask(GetTrieRoot());
+
+      if (++m_searchX == m_currentBoardWidth)
+      {
+        m_searchX = 0;
+        m_searchY++;
+      }
+    }
+    else
+    {
+      SSearchFrame& currentFrame = m_searchStack[m_searchDepth - 1];
+
+      if (currentFrame.nextDirection == m_neighbourOffsets.size() ||
+        currentFrame.pTrie->GetRemainingWords(m_searchContext) <= 0)
+      {
+        /// All neighbours are done, or every word below was found meanwhile,
+        /// so step back
+        SetBoardLetter(currentFrame.cell, currentFrame.letter);
+        m_searchDepth--;
+
+        continue;
+      }
+
+      /// There's no need for edge detection, as the border around the board
+      /// is made up of sentinels
+      cell = currentFrame.cell + m_neighbourOffsets[currentFrame.nextDirection++];
+      pCurrentTrie = currentFrame.pTrie;
+      candidateMask = currentFrame.candidateMask;
+    }
+
+    const char currentBoardLetter = GetBoardLetter(cell);
+
+    if (!currentBoardLetter)
+    {
+      continue;
+    }
+
+    const common::CTriePoolOptimized::LetterIndex_t letterAsIndex = common::CTriePoolOptimized::GetLetterAsIndex(currentBoardLetter);
+
+    /// A single bit test instead of a look at the children of the trie
+    if (!(candidateMask & (1u << letterAsIndex)))
+    {
+      continue;
+    }
+
+    const common::CTriePoolOptimized::Index_t foundTrie = pCurrentTrie->FindTrieWithStartingLetter(letterAsIndex, m_searchContext);
+
+    assert(foundTrie);
+
+    const common::CTriePoolOptimized* pFoundTrie = common::CTriePoolOptimized::GetPtrFromIndex(foundTrie);
+
+    ///
+    /// Only step onto the cell if one of its neighbours could continue a word.
+    /// Otherwise all 8 of them would be tried in vain.
+    ///
+    const uint32_t nextCandidateMask = GetSearchChildMask(foundTrie) & m_neighbourLetterMasks[cell];
+
+    if (nextCandidateMask && pFoundTrie->GetRemainingWords(m_searchContext) > 0)
+    {
+      assert(m_searchDepth < m_searchStack.size());
+
+      m_searchStack[m_searchDepth++] = { cell, pFoundTrie, 0, currentBoardLetter, nextCandidateMask };
+
+      SetBoardLetter(cell, char(0));
+    }
+  }
+
+  return false;
+}
+
+
+uint32_t boggle_game::CRuntime_TriePoolOptimized::FindWordsAndStandbyForWordRetrieving(const common::SBoardView& board)
+{
+  static_assert(C_MAX_WORD_LENGTH <= common::CVisitedWindow::C_RADIUS, "A path could leave the visited window");
+
+  m_sharedBoard = board;
+
+  m_searchContext.Reset();
+  m_searchContext.Prepare(common::CTriePoolOptimized::GetAllocatedTrieCount());
+
+  for (uint32_t y = 0; y < board.height; y++)
+  {
+    /// Stop as soon as every word of the dictionary is found
+    if (m_pTrie->GetRemainingWords(m_searchContext) <= 0)
+    {
+      break;
+    }
+
+    for (uint32_t x = 0; x < board.width; x++)
+    {
+      m_visited.Center(x, y);
+
+      DoSearchForWordsAtSharedBoardLocation(x, y, *m_pTrie);
+    }
+  }
+
+  m_sharedBoard = common::SBoardView();
+
+  return m_searchContext.GetFoundWordCount();
+}
+
+
+uint32_t boggle_game::CRuntime_TriePoolOptimized::RetrieveWordsAndGetScore(common::TContainerWriter<const char*> output)
+{
+  ///
+  /// The context knows exactly which words were found, so there's no need to
+  /// walk the trie.
+  ///
+  uint32_t currentScore = 0;
+
+  for (const common::CTriePoolOptimized::Index_t foundTrie : m_searchContext.GetFoundTries())
+  {
+    const char* pWord = common::CTriePoolOptimized::GetWord(common::CTriePoolOptimized::GetPtrFromIndex(foundTrie)->GetWordId());
+
+    output.container[output.currentIndex++] = pWord;
+    currentScore += GetScoreForWordLength(strlen(pWord));
+  }
+
+  return currentScore;
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+boggle_game::SBoggleResults boggle_game::CRuntime_TriePoolOptimized::GetResults(const uint32_t foundWordCount)
+{
+  ///
+  /// Word list, which needs to be allocated just for this purpose
+  ///
+  SBoggleResults result;
+
+  if (foundWordCount)
+  {
+    result.words.resize(foundWordCount, nullptr);
+
+    common::TContainerWriter<const char*> containerWriter;
+    containerWriter.container = &result.words.at(0);
+
+    result.score = RetrieveWordsAndGetScore(containerWriter);
+  }
+
+  return result;
+}
+
+
+uint32_t boggle_game::CRuntime_TriePoolOptimized::GetFoundScore() const
+{
+  uint32_t result = 0;
+
+  for (const common::CTriePoolOptimized::Index_t foundTrie : m_searchContext.GetFoundTries())
+  {
+    result += GetScoreForWordLength(strlen(common::CTriePoolOptimized::GetWord(common::CTriePoolOptimized::GetPtrFromIndex(foundTrie)->GetWordId())));
+  }
+
+  return result;
+}
+
+
+void boggle_game::CRuntime_TriePoolOptimized::PrefilterTries()
+{
+  for (const common::CTriePoolOptimized::Index_t trie : m_prefilteredTries)
+  {
+    m_prefilteredChildMasks[trie] = 0;
+  }
+
+  m_prefilteredTries.clear();
+
+  m_isPrefiltered = size_t(m_currentBoardWidth) * m_currentBoardHeight <= m_prefilterMaxCells;
+
+  if (!m_isPrefiltered)
+  {
+    return;
+  }
+
+  if (m_prefilteredChildMasks.size() < common::CTriePoolOptimized::GetAllocatedTrieCount())
+  {
+    m_prefilteredChildMasks.resize(common::CTriePoolOptimized::GetAllocatedTrieCount(), 0);
+  }
+
+  ///
+  /// Which letters are on the board, how often, and which letters are next to
+  /// each of them somewhere
+  ///
+  LetterTable_t bigramMasks = {};
+  LetterTable_t letterCounts = {};
+  uint32_t boardLetterMask = 0;
+
+  for (uint32_t y = 0; y < m_currentBoardHeight; y++)
+  {
+    for (uint32_t x = 0; x < m_currentBoardWidth; x++)
+    {
+      const size_t cell = GetBoardIndex(x, y);
+      const common::CTriePoolOptimized::LetterIndex_t letterAsIndex = common::CTriePoolOptimized::GetLetterAsIndex(GetBoardLetter(cell));
+
+      letterCounts[letterAsIndex]++;
+      boardLetterMask |= 1u << letterAsIndex;
+      bigramMasks[letterAsIndex] |= m_neighbourLetterMasks[cell];
+    }
+  }
+
+  PrefilterTrie(GetTrieRoot(), boardLetterMask, bigramMasks, letterCounts);
+}
+
+
+bool boggle_game::CRuntime_TriePoolOptimized::PrefilterTrie(
+  const common::CTriePoolOptimized::Index_t trie,
+  const uint32_t allowedChildMask,
+  const LetterTable_t& bigramMasks,
+  LetterTable_t& remainingLetterCounts
+)
+{
+  ///
+  /// A path through the trie can only be laid on the board if every pair of
+  /// letters on it is next to each other somewhere, and no letter is used more
+  /// often than it's on the board. Every child failing either check is hidden
+  /// from the search, together with all of its own children.
+  ///
+  const common::CTriePoolOptimized* pTrie = common::CTriePoolOptimized::GetPtrFromIndex(trie);
+
+  uint32_t childMask = pTrie->GetChildMask() & allowedChildMask;
+  uint32_t liveChildMask = 0;
+
+  while (childMask)
+  {
+    const common::CTriePoolOptimized::LetterIndex_t letterAsIndex = common::CTriePoolOptimized::LetterIndex_t(common::CountTrailingZeros(childMask));
+    childMask &= childMask - 1;
+
+    if (!remainingLetterCounts[letterAsIndex])
+    {
+      continue;
+    }
+
+    remainingLetterCounts[letterAsIndex]--;
+
+    if (PrefilterTrie(pTrie->GetChild(letterAsIndex), bigramMasks[letterAsIndex], bigramMasks, remainingLetterCounts))
+    {
+      liveChildMask |= 1u << letterAsIndex;
+    }
+
+    remainingLetterCounts[letterAsIndex]++;
+  }
+
+  if (liveChildMask)
+  {
+    m_prefilteredChildMasks[trie] = liveChildMask;
+    m_prefilteredTries.push_back(trie);
+  }
+
+  return liveChildMask || pTrie->GetWordId();
+}
+
+
+void boggle_game::CRuntime_TriePoolOptimized::DoSearchForWordsAtSharedBoardLocation(
+  const uint32_t x,
+  const uint32_t y,
+  const common::CTriePoolOptimized& currentTrie
+)
+{
+  if (m_visited.IsVisited(x, y))
+  {
+    return;
+  }
+
+  const char currentBoardLetter = m_sharedBoard.GetLetter(x, y);
+
+  const common::CTriePoolOptimized::LetterIndex_t letterAsIndex = common::CTriePoolOptimized::GetLetterAsIndex(currentBoardLetter);
+
+  common::CTriePoolOptimized::Index_t foundTrie = currentTrie.FindTrieWithStartingLetter(letterAsIndex, m_searchContext);
+
+  if (!foundTrie)
+  {
+    return;
+  }
+
+  const common::CTriePoolOptimized* pFoundTrie = common::CTriePoolOptimized::GetPtrFromIndex(foundTrie);
+
+  if (pFoundTrie->GetRemainingWords(m_searchContext) > 0)
+  {
+    ///
+    /// Check all directions for a match
+    ///
+
+    enum Axis_t : uint8_t
+    {
+      X = 0,
+      Y = 1,
+      MAX
+    };
+    typedef int8_t Direction_t[Axis_t::MAX];
+
+    static const Direction_t s_directions[] =
+    {
+      { -1,  0 },
+      { -1, -1 },
+      { 0, -1 },
+      { 1, -1 },
+      { 1,  0 },
+      { 1,  1 },
+      { 0,  1 },
+      { -1,  1 },
+    };
+
+    m_visited.SetVisited(x, y);
+
+    for (uint32_t i = 0; i < common::GetArrayLength(s_directions); i++)
+    {
+      const Direction_t& currentDirection = s_directions[i];
+      const uint32_t currentX = x + currentDirection[Axis_t::X];
+      const uint32_t currentY = y + currentDirection[Axis_t::Y];
+
+      /// Edge detection. Notice how minus values underflow, and as such we only
+      /// need to test for max, not minimum.
+      if (currentX >= m_sharedBoard.width || currentY >= m_sharedBoard.height)
+      {
+        continue;
+      }
+
+      DoSearchForWordsAtSharedBoardLocation(currentX, currentY, *pFoundTrie);
+    }
+
+    m_visited.ClearVisited(x, y);
+  }
+}
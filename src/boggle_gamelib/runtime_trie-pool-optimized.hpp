@@ -1,60 +1,186 @@
-#pragma once
-
-#include "runtime_base.hpp"
-
-#include <common/containers/trie-pool-optimized.hpp>
-
-#include <cassert>
-
-
-// ----------------------------------------------------------------------------
-
-
-namespace common
-{
-  class CTriePoolOptimized;
-}
-
-
-// ----------------------------------------------------------------------------
-
-
-namespace boggle_game
-{
-  class CRuntime_TriePoolOptimized : public CRuntime_Base
-  {
-  public:
-
-    CRuntime_TriePoolOptimized();
-    virtual ~CRuntime_TriePoolOptimized();
-    
-    virtual void LoadDictionary(const char* path) override;
-    virtual SBoggleResults FindWords(const char* board, uint32_t width, uint32_t height) override;
-
-    void InitializeTrieRoot();
-    void AddWord(const std::string& word);
-    uint32_t FindWordsAndStandbyForWordRetrieving(const char* board, unsigned width, unsigned height);
-    uint32_t RetrieveWordsAndGetScore(common::TContainerWriter<const char*> output);
-
-  private:
-    void DoSearchForWordsAtBoardLocation(
-      const uint32_t x,
-      const uint32_t y,
-      common::CTriePoolOptimized& currentTrie
-    );
-
-  private:
-    common::CTriePoolOptimized* m_pTrie = nullptr;
-  };
-}
-
-
-// ----------------------------------------------------------------------------
-
-
-inline void boggle_game::CRuntime_TriePoolOptimized::AddWord(const std::string& word)
-{
-  assert(m_pTrie);
-
-  m_pTrie->AddWord(word);
-}
+#pragma once
+
+#include "runtime_base.hpp"
+
+#include <common/containers/board-view.hpp>
+#include <common/containers/trie-pool-optimized.hpp>
+
+#include <array>
+#include <cassert>
+#include <string_view>
+
+
+// ----------------------------------------------------------------------------
+
+
+namespace common
+{
+  class CTriePoolOptimized;
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+namespace boggle_game
+{
+  class CRuntime_TriePoolOptimized : public CRuntime_Base
+  {
+  public:
+
+    CRuntime_TriePoolOptimized();
+    virtual ~CRuntime_TriePoolOptimized();
+    
+    virtual void LoadDictionary(const char* path) override;
+    virtual SBoggleResults FindWords(const char* board, uint32_t width, uint32_t height) override;
+    virtual uint32_t FindScore(const char* board, uint32_t width, uint32_t height) override;
+
+    /// The compiled dictionary holds every trie of the shared pool, so loading
+    /// one replaces the tries of all other runtimes as well.
+    virtual bool SaveCompiledDictionary(const char* path) const override;
+    virtual bool LoadCompiledDictionary(const char* path) override;
+
+    void InitializeTrieRoot();
+    void AttachTrieRoot(const common::CTriePoolOptimized::Index_t root);
+    common::CTriePoolOptimized::Index_t GetTrieRoot() const;
+    void AddWord(const std::string_view word);
+    void AddWord(const std::string_view word, common::CTriePoolOptimizedRegion& region);
+    uint32_t FindWordsAndStandbyForWordRetrieving(const char* board, unsigned width, unsigned height);
+
+    /// Same as above, but in steps: BeginSearch copies the board, and each
+    /// ResumeSearch runs until <maxSteps> cells have been tried. Returns true
+    /// once the whole board has been searched.
+    void BeginSearch(const char* board, unsigned width, unsigned height);
+    bool ResumeSearch(uint32_t maxSteps);
+    uint32_t GetFoundWordCount() const;
+
+    /// Boards with up to <maxCells> cells get the trie filtered before the
+    /// search: every path with a pair of letters that's nowhere next to each
+    /// other on the board, or with more of a letter than the board has, is
+    /// hidden. 0, the default, never filters. The search itself only steps
+    /// onto letters that are next to the current cell, so this rarely pays
+    /// for the extra walk over the trie.
+    void SetPrefilterMaxCells(const uint32_t maxCells);
+
+    /// Same as above, but the board is read in place instead of being copied,
+    /// and the current path is tracked in a small window of its own. Any
+    /// number of runtimes can search the same board at once.
+    uint32_t FindWordsAndStandbyForWordRetrieving(const common::SBoardView& board);
+
+    uint32_t RetrieveWordsAndGetScore(common::TContainerWriter<const char*> output);
+
+  protected:
+    /// Results of the last search, which found <foundWordCount> words
+    SBoggleResults GetResults(const uint32_t foundWordCount);
+
+    /// Score of the words found by the last search
+    uint32_t GetFoundScore() const;
+
+  protected:
+    common::CTriePoolOptimized* m_pTrie = nullptr;
+
+    /// Per search state, so the trie can be reused for any number of boards
+    common::CTriePoolOptimizedSearchContext m_searchContext;
+
+  private:
+    /// One letter of the current path
+    struct SSearchFrame
+    {
+      size_t cell;
+      const common::CTriePoolOptimized* pTrie;
+      uint8_t nextDirection;
+      char letter;
+
+      /// Letters both around the cell and among the children of the trie
+      uint32_t candidateMask;
+    };
+
+    typedef std::array<uint32_t, common::CTriePoolOptimized::C_CHILDREN_COUNT> LetterTable_t;
+
+    void PrefilterTries();
+
+    /// Returns true if a word can still be found in or below <trie>
+    bool PrefilterTrie(
+      const common::CTriePoolOptimized::Index_t trie,
+      const uint32_t allowedChildMask,
+      const LetterTable_t& bigramMasks,
+      LetterTable_t& remainingLetterCounts
+    );
+
+    /// Children of <trie> worth trying on this board
+    uint32_t GetSearchChildMask(const common::CTriePoolOptimized::Index_t trie) const;
+
+    void DoSearchForWordsAtSharedBoardLocation(
+      const uint32_t x,
+      const uint32_t y,
+      const common::CTriePoolOptimized& currentTrie
+    );
+
+  private:
+    /// Only used while searching a shared board
+    common::SBoardView m_sharedBoard;
+    common::CVisitedWindow m_visited;
+
+    /// Letters of the 8 neighbours of every cell of the board copy, as a
+    /// mask of letter indices
+    std::vector<uint32_t> m_neighbourLetterMasks;
+
+    ///
+    /// Per trie mask of the children that can still lead to a word on the
+    /// current board, if the board was small enough to filter. The entries
+    /// of m_prefilteredTries are set, every other one is 0.
+    ///
+    uint32_t m_prefilterMaxCells = 0;
+    bool m_isPrefiltered = false;
+    std::vector<uint32_t> m_prefilteredChildMasks;
+    std::vector<common::CTriePoolOptimized::Index_t> m_prefilteredTries;
+
+    /// The path searched so far. A path can't be longer than a word, so the
+    /// stack never grows.
+    std::array<SSearchFrame, C_MAX_WORD_LENGTH> m_searchStack;
+    uint32_t m_searchDepth = 0;
+
+    /// Next board cell to start a path at
+    uint32_t m_searchX = 0;
+    uint32_t m_searchY = 0;
+  };
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+inline void boggle_game::CRuntime_TriePoolOptimized::AddWord(const std::string_view word)
+{
+  assert(m_pTrie);
+
+  m_pTrie->AddWord(word);
+}
+
+
+inline void boggle_game::CRuntime_TriePoolOptimized::AddWord(const std::string_view word, common::CTriePoolOptimizedRegion& region)
+{
+  assert(m_pTrie);
+
+  m_pTrie->AddWord(word, region);
+}
+
+
+inline uint32_t boggle_game::CRuntime_TriePoolOptimized::GetFoundWordCount() const
+{
+  return m_searchContext.GetFoundWordCount();
+}
+
+
+inline void boggle_game::CRuntime_TriePoolOptimized::SetPrefilterMaxCells(const uint32_t maxCells)
+{
+  m_prefilterMaxCells = maxCells;
+}
+
+
+inline uint32_t boggle_game::CRuntime_TriePoolOptimized::GetSearchChildMask(const common::CTriePoolOptimized::Index_t trie) const
+{
+  return m_isPrefiltered
+    ? m_prefilteredChildMasks[trie]
+    : common::CTriePoolOptimized::GetPtrFromIndex(trie)->GetChildMask();
+}
@@ -1,176 +1,297 @@
-#include "runtime_trie-threaded.hpp"
-
-#include <common/utils.hpp>
-
-#include <fstream>
-#include <iostream>
-
-
-// ----------------------------------------------------------------------------
-
-
-boggle_game::CRuntime_TrieThreaded::CRuntime_TrieThreaded()
-{
-  common::CTriePoolOptimized::InitializePool();
-}
-
-
-boggle_game::CRuntime_TrieThreaded::~CRuntime_TrieThreaded()
-{
-  for (size_t i = 0; i < m_workers.size(); i++)
-  {
-    m_workers[i].pThread.release();
-  }
-  
-  m_workers.clear();
-  
-  common::CTriePoolOptimized::ClearAllTries();
-}
-
-
-void boggle_game::CRuntime_TrieThreaded::LoadDictionary(const char* path)
-{
-  std::ifstream fileStream(path, std::ifstream::binary);
-  if (!fileStream)
-  {
-    std::cout << "Couldn't open dictionary: " << path << std::endl;
-    return;
-  }
-
-  m_workers.resize( std::thread::hardware_concurrency() );
-
-
-  char threadLetter[common::CTriePoolOptimized::C_CHILDREN_COUNT];
-  {
-    uint8_t currentThreadIndex = 0;
-    for (char& c : threadLetter)
-    {
-      c = (currentThreadIndex++) % m_workers.size();
-    }
-  }
-
-
-  for (auto& var : m_workers)
-  {
-    var.runtime.InitializeTrieRoot();
-  }
-
-
-  std::string currentWord;
-  while ( std::getline(fileStream, currentWord) )
-  {
-    if (currentWord.empty())
-    {
-      continue;
-    }
-    
-    const char lastLetter = currentWord.at(currentWord.length() - 1);
-    
-    if (!isalpha(lastLetter))
-    {
-      currentWord.resize(currentWord.length() - 1);
-    }
-
-    /// According to the rules then a valid word must be 3 or more letters, so
-    /// start by eliminating words with less letters than that.
-    if (currentWord.length() < 3)
-    {
-      continue;
-    }
-
-    /// Our own limitation to optimize a lookup table.
-    if (currentWord.length() > C_MAX_WORD_LENGTH)
-    {
-      continue;
-    }
-
-    //std::transform(currentWord.begin(), currentWord.end(), currentWord.begin(), ::tolower);
-
-    const size_t currentWorkerIndex = threadLetter[ currentWord[0] - 'a' ];
-
-    auto& currentWorker = m_workers[currentWorkerIndex].runtime;
-
-    currentWorker.AddWord(currentWord);
-  }
-}
-
-
-boggle_game::SBoggleResults boggle_game::CRuntime_TrieThreaded::FindWords(
-  const char* pBoard,
-  uint32_t width,
-  uint32_t height)
-{
-  static const int32_t C_UNINITIALIZED = -1;
-
-  std::vector<int32_t> wordCountsFromWorkers( m_workers.size(), C_UNINITIALIZED);
-
-  for (size_t i = 1; i < m_workers.size(); i++)
-  {
-    m_workers[i].pThread.reset(
-      new std::thread(
-        OnThread, std::ref(m_workers[i].runtime), pBoard, width, height, std::ref(wordCountsFromWorkers[i])
-      )
-    );
-  }
-
-  OnThread(m_workers[0].runtime, pBoard, width, height, wordCountsFromWorkers[0]);
-
-
-  for (size_t i = 1; i < m_workers.size(); i++)
-  {
-    m_workers[i].pThread->join();
-  }
-
-
-  for (const auto& val : wordCountsFromWorkers)
-  {
-    assert(val != C_UNINITIALIZED);
-  }
-
-
-  ///
-  /// Provide the result struct ...
-  ///
-
-
-  uint32_t foundWordsCount = 0;
-  {
-    for (size_t i = 0; i < wordCountsFromWorkers.size(); i++)
-    {
-      foundWordsCount += wordCountsFromWorkers[i];
-    }
-  }
-
-
-  
-  SBoggleResults result;
-
-  if (foundWordsCount)
-  {
-    result.words.resize(foundWordsCount, nullptr);
-
-    uint32_t currentOffset = 0;
-
-    for (size_t i = 0; i < m_workers.size(); i++)
-    {
-      common::TContainerWriter<const char*> containerWriter;
-      containerWriter.container = result.words.data() + currentOffset;
-
-      result.score += m_workers[i].runtime.RetrieveWordsAndGetScore(containerWriter);
-
-      currentOffset += wordCountsFromWorkers[i];
-    }
-  }
-
-
-  return result;
-}
-
-
-// ----------------------------------------------------------------------------
-
-
-void boggle_game::CRuntime_TrieThreaded::OnThread(Runtime_t& runtime, const char* pBoard, uint32_t width, uint32_t height, int32_t& wordCountOut)
-{
-  wordCountOut = runtime.FindWordsAndStandbyForWordRetrieving(pBoard, width, height);
-}
+#include "runtime_trie-threaded.hpp"
+
+#include <common/io/dictionary-reader.hpp>
+#include <common/io/mapped-file.hpp>
+#include <common/utils.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+
+// ----------------------------------------------------------------------------
+
+
+boggle_game::CRuntime_TrieThreaded::CRuntime_TrieThreaded(const uint32_t workerCount, const std::vector<uint32_t>& cpuAffinity)
+  : m_workerCount(workerCount)
+{
+  if (!m_workerCount)
+  {
+    m_workerCount = std::thread::hardware_concurrency();
+  }
+
+  if (!m_workerCount)
+  {
+    m_workerCount = 1;
+  }
+
+  common::CTriePoolOptimized::InitializePool();
+
+  m_threadPool.Start(m_workerCount - 1, cpuAffinity);
+}
+
+
+boggle_game::CRuntime_TrieThreaded::~CRuntime_TrieThreaded()
+{
+  m_threadPool.Stop();
+
+  m_workers.clear();
+  
+  common::CTriePoolOptimized::ClearAllTries();
+}
+
+
+void boggle_game::CRuntime_TrieThreaded::LoadDictionary(const char* path)
+{
+  common::CMappedFile file;
+  if (!file.Open(path))
+  {
+    std::cout << "Couldn't open dictionary: " << path << std::endl;
+    return;
+  }
+
+  m_workers.resize( m_workerCount );
+
+
+  for (auto& var : m_workers)
+  {
+    var.runtime.InitializeTrieRoot();
+  }
+
+
+  ///
+  /// Every worker reads its own byte range of the file, and sorts the words
+  /// by their first two letters. The slot for reader R and prefix P is at
+  /// R * C_PREFIX_COUNT + P.
+  ///
+  const size_t workerCount = m_workers.size();
+
+  std::vector<std::vector<std::string_view>> handOffs(workerCount * C_PREFIX_COUNT);
+
+  const char* const pFileBegin = file.GetData();
+  const char* const pFileEnd = pFileBegin + file.GetSize();
+  const size_t bytesPerWorker = (file.GetSize() / workerCount) + 1;
+
+  RunOnAllWorkers([&](const size_t readerIndex)
+  {
+    const char* pBegin = common::FindLineStart(pFileBegin, pFileEnd, readerIndex * bytesPerWorker);
+    const char* pEnd = common::FindLineStart(pFileBegin, pFileEnd, (readerIndex + 1) * bytesPerWorker);
+
+    std::vector<std::string_view>* pReaderHandOffs = &handOffs[readerIndex * C_PREFIX_COUNT];
+
+    common::ForEachDictionaryWord(pBegin, pEnd, C_MIN_WORD_LENGTH, C_MAX_WORD_LENGTH,
+      [&](const std::string_view currentWord)
+      {
+        pReaderHandOffs[ GetPrefixIndex(currentWord) ].push_back(currentWord);
+      });
+  });
+
+
+  ///
+  /// Hand out the prefixes by the number of words below them, heaviest first
+  /// and always to the worker with the fewest words so far. Some letters are
+  /// far more common than others, so this keeps the tries - and thereby the
+  /// searches - much closer in size than a fixed split by letter would.
+  ///
+  std::vector<size_t> prefixWordCounts(C_PREFIX_COUNT, 0);
+  for (size_t i = 0; i < handOffs.size(); i++)
+  {
+    prefixWordCounts[i % C_PREFIX_COUNT] += handOffs[i].size();
+  }
+
+  std::vector<uint32_t> prefixesByWordCount(C_PREFIX_COUNT);
+  for (uint32_t i = 0; i < C_PREFIX_COUNT; i++)
+  {
+    prefixesByWordCount[i] = i;
+  }
+
+  std::stable_sort(prefixesByWordCount.begin(), prefixesByWordCount.end(),
+    [&](const uint32_t left, const uint32_t right)
+    {
+      return prefixWordCounts[left] > prefixWordCounts[right];
+    });
+
+  std::vector<size_t> ownerWordCounts(workerCount, 0);
+  std::vector<std::vector<uint32_t>> ownerPrefixes(workerCount);
+
+  for (const uint32_t prefix : prefixesByWordCount)
+  {
+    if (!prefixWordCounts[prefix])
+    {
+      break;
+    }
+
+    const size_t ownerIndex = std::min_element(ownerWordCounts.begin(), ownerWordCounts.end()) - ownerWordCounts.begin();
+
+    ownerWordCounts[ownerIndex] += prefixWordCounts[prefix];
+    ownerPrefixes[ownerIndex].push_back(prefix);
+  }
+
+
+  ///
+  /// ... and then every worker builds its own trie. New tries are taken from
+  /// a region reserved by the worker, so there's no contention on the pool.
+  /// Words sharing a path always share the prefix as well, and are added in
+  /// file order, so the last one still wins.
+  ///
+  RunOnAllWorkers([&](const size_t ownerIndex)
+  {
+    common::CTriePoolOptimizedRegion region;
+
+    auto& currentWorker = m_workers[ownerIndex].runtime;
+
+    for (const uint32_t prefix : ownerPrefixes[ownerIndex])
+    {
+      for (size_t readerIndex = 0; readerIndex < workerCount; readerIndex++)
+      {
+        for (const std::string_view currentWord : handOffs[(readerIndex * C_PREFIX_COUNT) + prefix])
+        {
+          currentWorker.AddWord(currentWord, region);
+        }
+      }
+    }
+  });
+}
+
+
+bool boggle_game::CRuntime_TrieThreaded::SaveCompiledDictionary(const char* path) const
+{
+  std::vector<common::CTriePoolOptimized::Index_t> roots;
+
+  for (const auto& var : m_workers)
+  {
+    roots.push_back(var.runtime.GetTrieRoot());
+  }
+
+  return common::CTriePoolOptimized::SaveCompiledDictionary(path, roots);
+}
+
+
+bool boggle_game::CRuntime_TrieThreaded::LoadCompiledDictionary(const char* path)
+{
+  m_workers.clear();
+
+  std::vector<common::CTriePoolOptimized::Index_t> roots;
+
+  if (!common::CTriePoolOptimized::LoadCompiledDictionary(path, roots))
+  {
+    std::cout << "Couldn't load compiled dictionary: " << path << std::endl;
+    return false;
+  }
+
+  ///
+  /// Every worker has its own trie, so the worker count is given by the
+  /// image, and not by the machine loading it.
+  ///
+  m_workers.resize(roots.size());
+
+  for (size_t i = 0; i < roots.size(); i++)
+  {
+    m_workers[i].runtime.AttachTrieRoot(roots[i]);
+  }
+
+  return true;
+}
+
+
+boggle_game::SBoggleResults boggle_game::CRuntime_TrieThreaded::FindWords(
+  const char* pBoard,
+  uint32_t width,
+  uint32_t height)
+{
+  return FindWords(pBoard, width, height, width);
+}
+
+
+boggle_game::SBoggleResults boggle_game::CRuntime_TrieThreaded::FindWords(
+  const char* pBoard,
+  uint32_t width,
+  uint32_t height,
+  size_t stride)
+{
+  static const int32_t C_UNINITIALIZED = -1;
+
+  ///
+  /// Every worker searches the very same board, so memory use and setup time
+  /// don't grow with the number of workers.
+  ///
+  const common::SBoardView board(pBoard, width, height, stride);
+
+  std::vector<int32_t> wordCountsFromWorkers( m_workers.size(), C_UNINITIALIZED);
+
+  RunOnAllWorkers([&](const size_t workerIndex)
+  {
+    OnThread(m_workers[workerIndex].runtime, board, wordCountsFromWorkers[workerIndex]);
+  });
+
+
+  for (const auto& val : wordCountsFromWorkers)
+  {
+    assert(val != C_UNINITIALIZED);
+  }
+
+
+  ///
+  /// Provide the result struct ...
+  ///
+
+
+  uint32_t foundWordsCount = 0;
+  {
+    for (size_t i = 0; i < wordCountsFromWorkers.size(); i++)
+    {
+      foundWordsCount += wordCountsFromWorkers[i];
+    }
+  }
+
+
+  
+  SBoggleResults result;
+
+  if (foundWordsCount)
+  {
+    result.words.resize(foundWordsCount, nullptr);
+
+    uint32_t currentOffset = 0;
+
+    for (size_t i = 0; i < m_workers.size(); i++)
+    {
+      common::TContainerWriter<const char*> containerWriter;
+      containerWriter.container = result.words.data() + currentOffset;
+
+      result.score += m_workers[i].runtime.RetrieveWordsAndGetScore(containerWriter);
+
+      currentOffset += wordCountsFromWorkers[i];
+    }
+  }
+
+
+  return result;
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+uint32_t boggle_game::CRuntime_TrieThreaded::GetPrefixIndex(const std::string_view word)
+{
+  assert(word.length() >= 2);
+
+  ///
+  /// A "qu" is a single letter on the board, so it's a single letter in the
+  /// prefix as well.
+  ///
+  const size_t secondLetter = (word[0] == 'q' && word[1] == 'u' && word.length() > 2) ? 2 : 1;
+
+  const uint32_t first = common::CTriePoolOptimized::GetLetterAsIndex(word[0]);
+  const uint32_t second = common::CTriePoolOptimized::GetLetterAsIndex(word[secondLetter]);
+
+  return (first * common::CTriePoolOptimized::C_CHILDREN_COUNT) + second;
+}
+
+
+void boggle_game::CRuntime_TrieThreaded::OnThread(Runtime_t& runtime, const common::SBoardView& board, int32_t& wordCountOut)
+{
+  wordCountOut = runtime.FindWordsAndStandbyForWordRetrieving(board);
+}
@@ -1,40 +1,78 @@
-#pragma once
-
-#include "runtime_trie-pool-optimized.hpp"
-
-#include <cassert>
-#include <thread>
-
-
-// ----------------------------------------------------------------------------
-
-
-namespace boggle_game
-{
-  class CRuntime_TrieThreaded : public IRuntime
-  {
-  public:
-
-    CRuntime_TrieThreaded();
-    virtual ~CRuntime_TrieThreaded();
-    
-    virtual void LoadDictionary(const char* path) override;
-    virtual SBoggleResults FindWords(const char* board, uint32_t width, uint32_t height) override;
-
-  private:
-    typedef CRuntime_TriePoolOptimized Runtime_t;
-    static void OnThread(Runtime_t& runtime, const char* pBoard, uint32_t width, uint32_t height, int32_t& wordCountOut);
-
-  private:
-    struct WorkerEntry_t
-    {
-      Runtime_t runtime;
-      std::unique_ptr<std::thread> pThread;
-    };
-
-    std::vector<WorkerEntry_t> m_workers;
-  };
-}
-
-
-// ----------------------------------------------------------------------------
+#pragma once
+
+#include "runtime_trie-pool-optimized.hpp"
+
+#include <common/threading/thread-pool.hpp>
+
+#include <cassert>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+
+// ----------------------------------------------------------------------------
+
+
+namespace boggle_game
+{
+  class CRuntime_TrieThreaded : public IRuntime
+  {
+  public:
+
+    /// <workerCount> of 0 uses one worker per hardware thread. The calling
+    /// thread acts as the first worker, and the others are kept parked in a
+    /// pool between the calls. If <cpuAffinity> isn't empty, the pooled
+    /// threads are pinned to those CPUs in turn.
+    CRuntime_TrieThreaded(const uint32_t workerCount = 0, const std::vector<uint32_t>& cpuAffinity = {});
+    virtual ~CRuntime_TrieThreaded();
+    
+    virtual void LoadDictionary(const char* path) override;
+    virtual SBoggleResults FindWords(const char* board, uint32_t width, uint32_t height) override;
+
+    /// Same as above, for a board where rows are <stride> bytes apart. All
+    /// workers read the board in place, so it isn't copied at all, and it
+    /// must stay unchanged until the call returns.
+    SBoggleResults FindWords(const char* board, uint32_t width, uint32_t height, size_t stride);
+
+    virtual bool SaveCompiledDictionary(const char* path) const override;
+    virtual bool LoadCompiledDictionary(const char* path) override;
+
+  private:
+    typedef CRuntime_TriePoolOptimized Runtime_t;
+
+    /// Words are split between the workers by their first two letters
+    static const uint32_t C_PREFIX_COUNT = common::CTriePoolOptimized::C_CHILDREN_COUNT * common::CTriePoolOptimized::C_CHILDREN_COUNT;
+    static uint32_t GetPrefixIndex(const std::string_view word);
+
+    static void OnThread(Runtime_t& runtime, const common::SBoardView& board, int32_t& wordCountOut);
+
+    /// Call <function> with every worker index, spread over the calling and
+    /// the pooled threads, and wait for all of them to finish.
+    template <class TFunction>
+    void RunOnAllWorkers(TFunction&& function);
+
+  private:
+    struct WorkerEntry_t
+    {
+      Runtime_t runtime;
+    };
+
+    std::vector<WorkerEntry_t> m_workers;
+    uint32_t m_workerCount = 0;
+
+    common::CThreadPool m_threadPool;
+  };
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+template <class TFunction>
+inline void boggle_game::CRuntime_TrieThreaded::RunOnAllWorkers(TFunction&& function)
+{
+  m_threadPool.RunForEachIndex(m_workers.size(), function);
+}
+
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,167 @@
+#pragma once
+
+
+///
+/// Read-only view of a board owned by somebody else
+///
+
+// ----------------------------------------------------------------------------
+
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+
+// ----------------------------------------------------------------------------
+
+
+namespace common
+{
+  /// A board in the callers own memory. Rows are <stride> bytes apart, so a
+  /// view can also refer to a part of a bigger buffer. Nothing is copied, so
+  /// the memory must stay valid and unchanged while the view is used.
+  struct SBoardView
+  {
+    const char* pData = nullptr;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    size_t stride = 0;
+
+    SBoardView() {}
+    SBoardView(const char* pData, const uint32_t width, const uint32_t height, const size_t stride);
+
+    char GetLetter(const uint32_t x, const uint32_t y) const;
+
+    /// Offset of <x>, <y> from pData, which takes more than 32 bits on big
+    /// boards
+    size_t GetIndex(const uint32_t x, const uint32_t y) const;
+  };
+
+
+  // ----------------------------------------------------------------------------
+
+
+  /// Cells visited by the current path, for searches that can't mark the
+  /// board itself. A path never gets further than C_RADIUS cells away from
+  /// where it started, so a 32x32 bit window around the start cell covers it,
+  /// no matter how big the board is.
+  class CVisitedWindow
+  {
+  public:
+
+    static const uint32_t C_SIZE = 32;
+    static const uint32_t C_RADIUS = (C_SIZE / 2) - 1;
+
+    CVisitedWindow();
+
+    /// Move the window to a new start cell. Every cell must be unvisited.
+    void Center(const uint32_t x, const uint32_t y);
+
+    bool IsVisited(const uint32_t x, const uint32_t y) const;
+    void SetVisited(const uint32_t x, const uint32_t y);
+    void ClearVisited(const uint32_t x, const uint32_t y);
+
+  private:
+    uint32_t GetBit(const uint32_t x) const;
+    uint32_t GetRow(const uint32_t y) const;
+
+  private:
+    /// Notice how these may underflow close to the edges, which is fine as
+    /// only the differences are used.
+    uint32_t m_originX = 0;
+    uint32_t m_originY = 0;
+
+    std::array<uint32_t, C_SIZE> m_rows;
+  };
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+inline common::SBoardView::SBoardView(const char* pData, const uint32_t width, const uint32_t height, const size_t stride)
+  : pData(pData)
+  , width(width)
+  , height(height)
+  , stride(stride)
+{
+  assert(stride >= width);
+}
+
+
+inline char common::SBoardView::GetLetter(const uint32_t x, const uint32_t y) const
+{
+  return pData[GetIndex(x, y)];
+}
+
+
+inline size_t common::SBoardView::GetIndex(const uint32_t x, const uint32_t y) const
+{
+  assert(x < width);
+  assert(y < height);
+
+  return x + (y * stride);
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+inline common::CVisitedWindow::CVisitedWindow()
+{
+  m_rows.fill(0);
+}
+
+
+inline void common::CVisitedWindow::Center(const uint32_t x, const uint32_t y)
+{
+#if defined(_DEBUG)
+  for (const uint32_t row : m_rows)
+  {
+    assert(!row && "The previous path wasn't fully cleared");
+  }
+#endif
+
+  m_originX = x - C_RADIUS;
+  m_originY = y - C_RADIUS;
+}
+
+
+inline bool common::CVisitedWindow::IsVisited(const uint32_t x, const uint32_t y) const
+{
+  return (m_rows[GetRow(y)] & GetBit(x)) != 0;
+}
+
+
+inline void common::CVisitedWindow::SetVisited(const uint32_t x, const uint32_t y)
+{
+  m_rows[GetRow(y)] |= GetBit(x);
+}
+
+
+inline void common::CVisitedWindow::ClearVisited(const uint32_t x, const uint32_t y)
+{
+  m_rows[GetRow(y)] &= ~GetBit(x);
+}
+
+
+inline uint32_t common::CVisitedWindow::GetBit(const uint32_t x) const
+{
+  const uint32_t column = x - m_originX;
+
+  assert(column < C_SIZE && "The path got further away than C_RADIUS");
+
+  return 1u << column;
+}
+
+
+inline uint32_t common::CVisitedWindow::GetRow(const uint32_t y) const
+{
+  const uint32_t row = y - m_originY;
+
+  assert(row < C_SIZE && "The path got further away than C_RADIUS");
+
+  return row;
+}
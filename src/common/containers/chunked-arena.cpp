@@ -0,0 +1,118 @@
+#include "chunked-arena.hpp"
+
+#include <common/utils.hpp>
+
+#include <new>
+
+#ifdef _MSC_VER
+  #define WIN32_LEAN_AND_MEAN
+  #include <windows.h>
+#else
+  #include <sys/mman.h>
+#endif
+
+
+// ----------------------------------------------------------------------------
+
+
+common::CChunkedArena::~CChunkedArena()
+{
+  Release();
+}
+
+
+bool common::CChunkedArena::Initialize(const size_t elementSize, const size_t maxCount, const bool useHugePages)
+{
+  Release();
+
+  ///
+  /// Reserve one extra chunk, so the base can be aligned to a chunk. That
+  /// lets every chunk be backed by a single huge page.
+  ///
+  const size_t reservedSize = common::AlignUpTo(elementSize * maxCount, C_CHUNK_SIZE) + C_CHUNK_SIZE;
+
+#ifdef _MSC_VER
+  void* pReserved = VirtualAlloc(nullptr, reservedSize, MEM_RESERVE, PAGE_NOACCESS);
+  if (!pReserved)
+  {
+    return false;
+  }
+#else
+  void* pReserved = mmap(nullptr, reservedSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (pReserved == MAP_FAILED)
+  {
+    return false;
+  }
+#endif
+
+  m_pReserved = static_cast<uint8_t*>(pReserved);
+  m_reservedSize = reservedSize;
+
+  m_pBase = common::AlignUpToPtr(m_pReserved, C_CHUNK_SIZE);
+  m_elementSize = elementSize;
+  m_maxCount = maxCount;
+  m_useHugePages = useHugePages;
+
+  m_capacity = 0;
+  m_committedBytes = 0;
+
+  return true;
+}
+
+
+void common::CChunkedArena::Release()
+{
+  if (m_pReserved)
+  {
+#ifdef _MSC_VER
+    VirtualFree(m_pReserved, 0, MEM_RELEASE);
+#else
+    munmap(m_pReserved, m_reservedSize);
+#endif
+  }
+
+  m_pReserved = nullptr;
+  m_reservedSize = 0;
+  m_pBase = nullptr;
+  m_maxCount = 0;
+  m_capacity = 0;
+  m_committedBytes = 0;
+}
+
+
+void common::CChunkedArena::CommitUpTo(const size_t byteSize)
+{
+  if (!m_pBase || byteSize > m_elementSize * m_maxCount)
+  {
+    throw std::bad_alloc();
+  }
+
+  const size_t newCommittedBytes = common::AlignUpTo(byteSize, C_CHUNK_SIZE);
+
+  uint8_t* pChunks = m_pBase + m_committedBytes;
+  const size_t chunksSize = newCommittedBytes - m_committedBytes;
+
+#ifdef _MSC_VER
+  if (!VirtualAlloc(pChunks, chunksSize, MEM_COMMIT, PAGE_READWRITE))
+  {
+    throw std::bad_alloc();
+  }
+#else
+  if (mprotect(pChunks, chunksSize, PROT_READ | PROT_WRITE) != 0)
+  {
+    throw std::bad_alloc();
+  }
+
+  #if defined(MADV_HUGEPAGE)
+  if (m_useHugePages)
+  {
+    /// Only a hint. Without transparent huge pages we just get normal ones.
+    madvise(pChunks, chunksSize, MADV_HUGEPAGE);
+  }
+  #endif
+#endif
+
+  m_committedBytes = newCommittedBytes;
+
+  m_capacity.store(newCommittedBytes / m_elementSize, std::memory_order_release);
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+
+///
+/// Array of fixed size elements, which grows a chunk at a time
+///
+
+// ----------------------------------------------------------------------------
+
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+
+// ----------------------------------------------------------------------------
+
+
+namespace common
+{
+  struct SArenaUsage
+  {
+    size_t usedCount = 0;
+    size_t capacityCount = 0;
+    size_t maxCount = 0;
+    size_t committedBytes = 0;
+  };
+
+
+  /// Address space for the maximum element count is reserved up front, but
+  /// memory is only committed a chunk at a time as the elements are used. The
+  /// elements therefore never move, and an index maps to an address with a
+  /// single multiply - just like a plain array.
+  class CChunkedArena
+  {
+  public:
+
+    /// Each chunk is the size of a huge page, so a small arena stays cheap
+    static const size_t C_CHUNK_SIZE = 2 * 1024 * 1024;
+
+    CChunkedArena() {}
+    CChunkedArena(const CChunkedArena&) = delete;
+    ~CChunkedArena();
+
+    CChunkedArena& operator = (const CChunkedArena&) = delete;
+
+    /// Reserve the address space. Elements are aligned to C_CACHE_SIZE, as
+    /// long as <elementSize> is a multiple of it. Returns false if the address
+    /// space couldn't be reserved.
+    bool Initialize(const size_t elementSize, const size_t maxCount, const bool useHugePages);
+    void Release();
+
+    /// Make sure that the first <count> elements are committed. Safe to call
+    /// from several threads. Throws std::bad_alloc if <count> exceeds the
+    /// maximum, or if the memory couldn't be committed.
+    void EnsureCapacity(const size_t count);
+
+    uint8_t* GetBase() const;
+    size_t GetCapacity() const;
+    size_t GetMaxCount() const;
+    size_t GetCommittedBytes() const;
+
+  private:
+    void CommitUpTo(const size_t byteSize);
+
+  private:
+    uint8_t* m_pReserved = nullptr;
+    size_t m_reservedSize = 0;
+
+    uint8_t* m_pBase = nullptr;
+    size_t m_elementSize = 0;
+    size_t m_maxCount = 0;
+    bool m_useHugePages = false;
+
+    std::atomic<size_t> m_capacity { 0 };
+    size_t m_committedBytes = 0;
+    std::mutex m_growMutex;
+  };
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+inline void common::CChunkedArena::EnsureCapacity(const size_t count)
+{
+  if (count <= m_capacity.load(std::memory_order_acquire))
+  {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(m_growMutex);
+
+  /// Someone else might have grown it while we waited
+  if (count <= m_capacity.load(std::memory_order_relaxed))
+  {
+    return;
+  }
+
+  CommitUpTo(count * m_elementSize);
+}
+
+
+inline uint8_t* common::CChunkedArena::GetBase() const
+{
+  return m_pBase;
+}
+
+
+inline size_t common::CChunkedArena::GetCapacity() const
+{
+  return m_capacity.load(std::memory_order_acquire);
+}
+
+
+inline size_t common::CChunkedArena::GetMaxCount() const
+{
+  return m_maxCount;
+}
+
+
+inline size_t common::CChunkedArena::GetCommittedBytes() const
+{
+  return m_committedBytes;
+}
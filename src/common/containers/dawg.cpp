@@ -0,0 +1,336 @@
+#include "dawg.hpp"
+
+#include <algorithm>
+#include <array>
+#include <unordered_map>
+
+
+// ----------------------------------------------------------------------------
+
+
+namespace
+{
+  /// Node of the graph while it's being minimized. Index 0 is the root, which
+  /// is never anybody's child, so 0 doubles as "no child".
+  struct SBuilderNode
+  {
+    std::array<uint32_t, common::CDawg::C_CHILDREN_COUNT> children = {};
+    bool final = false;
+  };
+
+
+  /// Builds the minimal graph from sorted, unique paths, as described by
+  /// Daciuk et al. in "Incremental Construction of Minimal Acyclic Finite-State
+  /// Automata". Only the nodes along the last added path can still change, so
+  /// anything left of it is merged with an equal registered node right away.
+  class CDawgBuilder
+  {
+  public:
+    CDawgBuilder()
+    {
+      m_nodes.emplace_back();
+    }
+
+    void AddPath(const std::string& path)
+    {
+      size_t commonLength = 0;
+      while (commonLength < path.length() && commonLength < m_previousPath.length() &&
+        path[commonLength] == m_previousPath[commonLength])
+      {
+        commonLength++;
+      }
+
+      assert((commonLength < path.length() || path.length() == m_previousPath.length()) && "Paths must be sorted.");
+
+      Minimize(commonLength);
+
+      uint32_t current = m_unchecked.empty() ? 0 : m_unchecked.back().child;
+
+      for (size_t i = commonLength; i < path.length(); i++)
+      {
+        const uint32_t child = AllocateNode();
+        const auto letter = common::CDawg::GetLetterAsIndex(path[i]);
+
+        m_nodes[current].children[letter] = child;
+        m_unchecked.push_back({ current, letter, child });
+
+        current = child;
+      }
+
+      m_nodes[current].final = true;
+      m_previousPath = path;
+    }
+
+    void Finish()
+    {
+      Minimize(0);
+    }
+
+    const std::vector<SBuilderNode>& GetNodes() const
+    {
+      return m_nodes;
+    }
+
+  private:
+    struct SUnchecked
+    {
+      uint32_t parent;
+      common::CDawg::LetterIndex_t letter;
+      uint32_t child;
+    };
+
+    uint32_t AllocateNode()
+    {
+      if (!m_freeNodes.empty())
+      {
+        const uint32_t result = m_freeNodes.back();
+        m_freeNodes.pop_back();
+
+        m_nodes[result] = SBuilderNode();
+        return result;
+      }
+
+      m_nodes.emplace_back();
+      return static_cast<uint32_t>(m_nodes.size() - 1);
+    }
+
+    void Minimize(const size_t downTo)
+    {
+      while (m_unchecked.size() > downTo)
+      {
+        const SUnchecked unchecked = m_unchecked.back();
+        m_unchecked.pop_back();
+
+        const auto inserted = m_register.emplace(GetSignature(unchecked.child), unchecked.child);
+        if (!inserted.second)
+        {
+          m_nodes[unchecked.parent].children[unchecked.letter] = inserted.first->second;
+          m_freeNodes.push_back(unchecked.child);
+        }
+      }
+    }
+
+    /// Two nodes are equal if they agree on being final and have the very same
+    /// children, which have all been registered already.
+    std::string GetSignature(const uint32_t node) const
+    {
+      const SBuilderNode& builderNode = m_nodes[node];
+
+      std::string result;
+      result.push_back(builderNode.final ? 1 : 0);
+
+      for (uint8_t i = 0; i < common::CDawg::C_CHILDREN_COUNT; i++)
+      {
+        const uint32_t child = builderNode.children[i];
+        if (!child)
+        {
+          continue;
+        }
+
+        result.push_back(char(i));
+        result.append(reinterpret_cast<const char*>(&child), sizeof(child));
+      }
+
+      return result;
+    }
+
+  private:
+    std::vector<SBuilderNode> m_nodes;
+    std::vector<uint32_t> m_freeNodes;
+    std::vector<SUnchecked> m_unchecked;
+    std::unordered_map<std::string, uint32_t> m_register;
+    std::string m_previousPath;
+  };
+
+
+  uint32_t CountWords(const std::vector<SBuilderNode>& nodes, const uint32_t node, std::vector<uint32_t>& wordCounts)
+  {
+    /// Nodes are shared, so each one is only counted once
+    if (wordCounts[node] != ~uint32_t(0))
+    {
+      return wordCounts[node];
+    }
+
+    uint32_t result = nodes[node].final ? 1 : 0;
+
+    for (const uint32_t child : nodes[node].children)
+    {
+      if (child)
+      {
+        result += CountWords(nodes, child, wordCounts);
+      }
+    }
+
+    wordCounts[node] = result;
+    return result;
+  }
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void common::CDawg::Clear()
+{
+  m_nodes.clear();
+  m_edges.clear();
+  m_wordText.clear();
+  m_wordOffsets.clear();
+  m_wordScores.clear();
+  m_pendingWords.clear();
+}
+
+
+void common::CDawg::AddWord(const std::string_view word)
+{
+  std::string path;
+  path.reserve(word.length());
+
+  for (size_t i = 0; i < word.length(); i++)
+  {
+    const char currentLetter = word[i];
+    assert(currentLetter >= 'a' && currentLetter <= 'z');
+
+    if (currentLetter == 'q' && i + 1 < word.length() && word[i + 1] == 'u')
+    {
+      i++;
+    }
+
+    path.push_back(currentLetter);
+  }
+
+  m_pendingWords.emplace_back(std::move(path), std::string(word));
+}
+
+
+void common::CDawg::Build()
+{
+  m_nodes.clear();
+  m_edges.clear();
+  m_wordText.clear();
+  m_wordOffsets.clear();
+  m_wordScores.clear();
+
+  ///
+  /// The word numbers are the alphabetical ranks of the paths, so sorting
+  /// gives the word table right away. Words sharing a path (like "qintar" and
+  /// "quintar") are only stored once, and just like the other tries the last
+  /// one added is the one reported.
+  ///
+  std::stable_sort(m_pendingWords.begin(), m_pendingWords.end(),
+    [](const auto& left, const auto& right)
+    {
+      return left.first < right.first;
+    });
+
+  CDawgBuilder builder;
+
+  for (size_t i = 0; i < m_pendingWords.size(); i++)
+  {
+    if (i + 1 < m_pendingWords.size() && m_pendingWords[i].first == m_pendingWords[i + 1].first)
+    {
+      continue;
+    }
+
+    const auto& pendingWord = m_pendingWords[i];
+
+    builder.AddPath(pendingWord.first);
+
+    m_wordOffsets.push_back(static_cast<uint32_t>(m_wordText.size()));
+    m_wordScores.push_back(uint8_t(common::GetScoreForWordLength(pendingWord.second.length())));
+
+    m_wordText.insert(m_wordText.end(), pendingWord.second.begin(), pendingWord.second.end());
+    m_wordText.push_back('\0');
+  }
+
+  builder.Finish();
+
+  m_pendingWords.clear();
+  m_pendingWords.shrink_to_fit();
+
+  const std::vector<SBuilderNode>& builderNodes = builder.GetNodes();
+
+  std::vector<uint32_t> wordCounts(builderNodes.size(), ~uint32_t(0));
+  CountWords(builderNodes, 0, wordCounts);
+
+  ///
+  /// Breadth first, so the children of a node end up close to each other. The
+  /// list of builder nodes doubles as the queue, and a node shared by several
+  /// parents is only added the first time it's seen.
+  ///
+  std::vector<Index_t> compactIndices(builderNodes.size(), C_NO_CHILD);
+  std::vector<uint32_t> builderIndices;
+  builderIndices.push_back(0);
+  compactIndices[0] = C_ROOT;
+
+  for (size_t current = 0; current < builderIndices.size(); current++)
+  {
+    const SBuilderNode& builderNode = builderNodes[builderIndices[current]];
+
+    for (const uint32_t child : builderNode.children)
+    {
+      if (child && compactIndices[child] == C_NO_CHILD)
+      {
+        compactIndices[child] = static_cast<Index_t>(builderIndices.size());
+        builderIndices.push_back(child);
+      }
+    }
+  }
+
+  m_nodes.reserve(builderIndices.size());
+
+  for (const uint32_t builderIndex : builderIndices)
+  {
+    const SBuilderNode& builderNode = builderNodes[builderIndex];
+
+    SNode node;
+    node.childMask = builderNode.final ? C_FINAL_BIT : 0;
+    node.firstEdge = static_cast<uint32_t>(m_edges.size());
+    node.wordCount = wordCounts[builderIndex];
+
+    /// A word ending right here ranks before all words below
+    uint32_t wordOffset = builderNode.final ? 1 : 0;
+
+    for (LetterIndex_t i = 0; i < C_CHILDREN_COUNT; i++)
+    {
+      const uint32_t child = builderNode.children[i];
+      if (!child)
+      {
+        continue;
+      }
+
+      node.childMask |= 1u << i;
+      m_edges.push_back({ compactIndices[child], wordOffset });
+
+      wordOffset += wordCounts[child];
+    }
+
+    m_nodes.push_back(node);
+  }
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void common::CDawgSearchContext::Prepare(const CDawg& dawg)
+{
+  m_found.resize(dawg.GetWordCount(), 0);
+  m_foundTree.resize(dawg.GetWordCount() + 1, 0);
+}
+
+
+void common::CDawgSearchContext::Reset()
+{
+  for (const WordId_t word : m_foundWords)
+  {
+    m_found[word] = 0;
+
+    for (size_t i = word + 1; i < m_foundTree.size(); i += i & (0 - i))
+    {
+      m_foundTree[i] = 0;
+    }
+  }
+
+  m_foundWords.clear();
+}
@@ -0,0 +1,286 @@
+#pragma once
+
+
+#include <common/utils.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+// ----------------------------------------------------------------------------
+
+
+namespace common
+{
+  class CDawgSearchContext;
+
+
+  /// Directed acyclic word graph: a trie where equal sub tries are merged, so
+  /// shared endings like "-ing" or "-ness" are only stored once. Since a node
+  /// can now be reached through many prefixes, it can't hold the word itself.
+  /// Instead every node knows how many words can be reached from it, which
+  /// gives each word a number equal to its alphabetical rank - a minimal
+  /// perfect hash. Found state is kept per word number in the search context.
+  ///
+  /// Words are collected with <AddWord>, and <Build> then creates the graph.
+  /// After that it's read-only.
+  class CDawg
+  {
+  public:
+
+    typedef uint8_t LetterIndex_t;
+    typedef uint32_t Index_t;
+    typedef uint32_t WordId_t;
+
+    static constexpr int32_t C_CHILDREN_COUNT = ('z' - 'a') + 1;
+
+    static constexpr Index_t C_ROOT = 0;
+    static constexpr Index_t C_NO_CHILD = ~Index_t(0);
+
+    /// Where a search currently is. Words reachable from here have the numbers
+    /// [word, word + wordCount of the node).
+    struct SState
+    {
+      Index_t node;
+      WordId_t word;
+    };
+
+    // ----------------------------------------------------------------------------
+
+
+    CDawg() {}
+    CDawg(const CDawg&) = delete;
+    CDawg& operator = (const CDawg&) = delete;
+
+    void Clear();
+
+    void AddWord(const std::string_view);
+    void Build();
+
+    /// Follow the letter index from <state>. Returns false if there's no such
+    /// child. Any word found is marked in the context.
+    bool FindTrieWithStartingLetter(const SState& state, const LetterIndex_t index, SState& childOut, CDawgSearchContext& context) const;
+
+    /// Number of words below <state> that haven't been found yet, not counting
+    /// a word ending right at it.
+    int32_t GetRemainingWords(const SState& state, const CDawgSearchContext& context) const;
+
+    uint32_t GetNodeCount() const;
+    uint32_t GetWordCount() const;
+
+    const char* GetWord(const WordId_t word) const;
+    uint32_t GetWordScore(const WordId_t word) const;
+
+    static LetterIndex_t GetLetterAsIndex(const char letter);
+
+  private:
+    static const uint32_t C_FINAL_BIT = 1u << 31;
+
+    struct SNode
+    {
+      /// Bit N is set if there's a child for letter N, and C_FINAL_BIT if a
+      /// word ends here.
+      uint32_t childMask;
+      uint32_t firstEdge;
+
+      /// Words reachable from here, including the one ending here
+      uint32_t wordCount;
+    };
+
+    struct SEdge
+    {
+      Index_t child;
+
+      /// Words ranked before the child's, among the words of the parent
+      uint32_t wordOffset;
+    };
+
+    std::vector<SNode> m_nodes;
+    std::vector<SEdge> m_edges;
+
+    /// Word text by word number, as zero terminated strings
+    std::vector<char> m_wordText;
+    std::vector<uint32_t> m_wordOffsets;
+    std::vector<uint8_t> m_wordScores;
+
+    /// Collected by <AddWord>, as (path, word) pairs, in the order added
+    std::vector<std::pair<std::string, std::string>> m_pendingWords;
+  };
+
+
+  // ----------------------------------------------------------------------------
+
+
+  /// State of a single search on a CDawg. The found words are counted in a
+  /// Fenwick tree over the word numbers, so the words still missing below any
+  /// node can be counted without visiting it. A reset is O(words found).
+  class CDawgSearchContext
+  {
+  public:
+
+    typedef CDawg::WordId_t WordId_t;
+
+    void Prepare(const CDawg& dawg);
+    void Reset();
+
+    bool IsFound(const WordId_t word) const;
+
+    /// Returns false if the word was already found during this search
+    bool MarkFound(const WordId_t word);
+
+    /// Found words with numbers in [begin, end)
+    int32_t GetFoundCount(const WordId_t begin, const WordId_t end) const;
+
+    const std::vector<WordId_t>& GetFoundWords() const;
+
+  private:
+    int32_t GetFoundCountBefore(WordId_t end) const;
+
+  private:
+    std::vector<uint8_t> m_found;
+    std::vector<int32_t> m_foundTree;
+    std::vector<WordId_t> m_foundWords;
+  };
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+inline bool common::CDawg::FindTrieWithStartingLetter(const SState& state, const LetterIndex_t index, SState& childOut, CDawgSearchContext& context) const
+{
+  assert(index < C_CHILDREN_COUNT);
+
+  const SNode& node = m_nodes[state.node];
+
+  const uint32_t letterBit = 1u << index;
+  if (!(node.childMask & letterBit))
+  {
+    return false;
+  }
+
+  const SEdge& edge = m_edges[node.firstEdge + PopCount(node.childMask & (letterBit - 1))];
+
+  childOut.node = edge.child;
+  childOut.word = state.word + edge.wordOffset;
+
+  if (m_nodes[edge.child].childMask & C_FINAL_BIT)
+  {
+    context.MarkFound(childOut.word);
+  }
+
+  return true;
+}
+
+
+inline int32_t common::CDawg::GetRemainingWords(const SState& state, const CDawgSearchContext& context) const
+{
+  const SNode& node = m_nodes[state.node];
+
+  const WordId_t begin = state.word + ((node.childMask & C_FINAL_BIT) ? 1 : 0);
+  const WordId_t end = state.word + node.wordCount;
+
+  if (begin == end)
+  {
+    return 0;
+  }
+
+  return int32_t(end - begin) - context.GetFoundCount(begin, end);
+}
+
+
+inline uint32_t common::CDawg::GetNodeCount() const
+{
+  return static_cast<uint32_t>(m_nodes.size());
+}
+
+
+inline uint32_t common::CDawg::GetWordCount() const
+{
+  return static_cast<uint32_t>(m_wordOffsets.size());
+}
+
+
+inline const char* common::CDawg::GetWord(const WordId_t word) const
+{
+  return &m_wordText[m_wordOffsets[word]];
+}
+
+
+inline uint32_t common::CDawg::GetWordScore(const WordId_t word) const
+{
+  return m_wordScores[word];
+}
+
+
+inline common::CDawg::LetterIndex_t common::CDawg::GetLetterAsIndex(const char letter)
+{
+  const auto result = letter - 'a';
+
+  assert(result < C_CHILDREN_COUNT);
+
+  return result;
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+inline bool common::CDawgSearchContext::IsFound(const WordId_t word) const
+{
+  return m_found[word] != 0;
+}
+
+
+inline bool common::CDawgSearchContext::MarkFound(const WordId_t word)
+{
+  if (m_found[word])
+  {
+    return false;
+  }
+
+  m_found[word] = 1;
+  m_foundWords.push_back(word);
+
+  for (size_t i = word + 1; i < m_foundTree.size(); i += i & (0 - i))
+  {
+    m_foundTree[i]++;
+  }
+
+  return true;
+}
+
+
+inline int32_t common::CDawgSearchContext::GetFoundCount(const WordId_t begin, const WordId_t end) const
+{
+  /// Most of the time nothing has been found at all
+  if (m_foundWords.empty())
+  {
+    return 0;
+  }
+
+  return GetFoundCountBefore(end) - GetFoundCountBefore(begin);
+}
+
+
+inline int32_t common::CDawgSearchContext::GetFoundCountBefore(WordId_t end) const
+{
+  int32_t result = 0;
+
+  for (; end > 0; end -= end & (0 - end))
+  {
+    result += m_foundTree[end];
+  }
+
+  return result;
+}
+
+
+inline const std::vector<common::CDawgSearchContext::WordId_t>& common::CDawgSearchContext::GetFoundWords() const
+{
+  return m_foundWords;
+}
@@ -0,0 +1,203 @@
+#include "trie-compact.hpp"
+
+
+// ----------------------------------------------------------------------------
+
+
+void common::CTrieCompact::Clear()
+{
+  m_nodes.clear();
+  m_wordText.clear();
+  m_wordOffsets.clear();
+  m_wordScores.clear();
+  m_builderNodes.clear();
+}
+
+
+void common::CTrieCompact::AddWord(const std::string_view word)
+{
+  if (m_builderNodes.empty())
+  {
+    m_builderNodes.emplace_back();
+  }
+
+  Index_t currentTrie = 0;
+
+  for (size_t i = 0; i < word.length(); i++)
+  {
+    const char currentLetter = word[i];
+    const auto currentIndex = GetLetterAsIndex(currentLetter);
+
+    if (currentLetter == 'q' && i + 1 < word.length() && word[i + 1] == 'u')
+    {
+      i++;
+    }
+
+    Index_t childIndex = m_builderNodes[currentTrie].children[currentIndex];
+    if (!childIndex)
+    {
+      childIndex = static_cast<Index_t>(m_builderNodes.size());
+
+      /// Notice how this may move the nodes, so no references are kept
+      m_builderNodes.emplace_back();
+      m_builderNodes[currentTrie].children[currentIndex] = childIndex;
+    }
+
+    currentTrie = childIndex;
+  }
+
+  ///
+  /// Words sharing a path (like "qintar" and "quintar") are only stored once,
+  /// and just like the other tries the last one added is the one reported.
+  ///
+  WordId_t& nodeWord = m_builderNodes[currentTrie].word;
+  if (nodeWord == C_NO_WORD)
+  {
+    nodeWord = static_cast<WordId_t>(m_wordOffsets.size());
+
+    m_wordOffsets.push_back(0);
+    m_wordScores.push_back(0);
+  }
+
+  m_wordOffsets[nodeWord] = static_cast<uint32_t>(m_wordText.size());
+  m_wordScores[nodeWord] = uint8_t(common::GetScoreForWordLength(word.length()));
+
+  m_wordText.insert(m_wordText.end(), word.begin(), word.end());
+  m_wordText.push_back('\0');
+}
+
+
+void common::CTrieCompact::Build()
+{
+  m_nodes.clear();
+
+  if (m_builderNodes.empty())
+  {
+    m_builderNodes.emplace_back();
+  }
+
+  ///
+  /// Breadth first, so all children of a node end up next to each other. The
+  /// list of builder nodes doubles as the queue.
+  ///
+  std::vector<Index_t> builderIndices;
+  builderIndices.reserve(m_builderNodes.size());
+  builderIndices.push_back(0);
+
+  m_nodes.reserve(m_builderNodes.size());
+
+  for (size_t current = 0; current < builderIndices.size(); current++)
+  {
+    const SBuilderNode& builderNode = m_builderNodes[builderIndices[current]];
+
+    SNode node;
+    node.childMask = 0;
+    node.firstChild = static_cast<Index_t>(builderIndices.size());
+    node.wordCount = 0;
+    node.word = builderNode.word;
+
+    for (LetterIndex_t i = 0; i < C_CHILDREN_COUNT; i++)
+    {
+      const Index_t childIndex = builderNode.children[i];
+      if (!childIndex)
+      {
+        continue;
+      }
+
+      node.childMask |= 1u << i;
+      builderIndices.push_back(childIndex);
+    }
+
+    m_nodes.push_back(node);
+  }
+
+  ///
+  /// Children always come after their parent, so going backwards gives the
+  /// word counts bottom up.
+  ///
+  for (size_t i = m_nodes.size(); i-- > 0;)
+  {
+    SNode& node = m_nodes[i];
+
+    const uint32_t childCount = PopCount(node.childMask);
+    for (uint32_t child = 0; child < childCount; child++)
+    {
+      const SNode& childNode = m_nodes[node.firstChild + child];
+
+      node.wordCount += childNode.wordCount + (childNode.word != C_NO_WORD ? 1 : 0);
+    }
+  }
+
+  m_builderNodes.clear();
+  m_builderNodes.shrink_to_fit();
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void common::CTrieCompactSearchContext::Prepare(const CTrieCompact& trie)
+{
+  m_found.resize(trie.GetWordCount(), 0);
+  m_foundChildWordCount.resize(trie.GetNodeCount(), 0);
+}
+
+
+void common::CTrieCompactSearchContext::Reset()
+{
+  for (size_t i = 0; i < m_foundWords.size(); i++)
+  {
+    m_found[m_foundWords[i]] = 0;
+    m_foundChildWordCount[m_foundWordParents[i]] = 0;
+  }
+
+  m_foundWords.clear();
+  m_foundWordParents.clear();
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void common::CTrieCompactSharedSearchContext::Prepare(const CTrieCompact& trie, const uint32_t workerCount)
+{
+  Reset();
+
+  /// Atomics can't be moved, so the arrays are only replaced when they grow
+  if (m_wordCount < trie.GetWordCount())
+  {
+    m_wordCount = trie.GetWordCount();
+    m_found.reset(new std::atomic<uint8_t>[m_wordCount]());
+  }
+
+  if (m_nodeCount < trie.GetNodeCount())
+  {
+    m_nodeCount = trie.GetNodeCount();
+    m_foundChildWordCount.reset(new std::atomic<int32_t>[m_nodeCount]());
+  }
+
+  m_remainingWordCount.store(int32_t(trie.GetWordCount()), std::memory_order_relaxed);
+
+  m_workers.resize(workerCount);
+
+  for (CWorker& worker : m_workers)
+  {
+    worker.m_pShared = this;
+  }
+}
+
+
+void common::CTrieCompactSharedSearchContext::Reset()
+{
+  for (CWorker& worker : m_workers)
+  {
+    for (size_t i = 0; i < worker.m_foundWords.size(); i++)
+    {
+      m_found[worker.m_foundWords[i]].store(0, std::memory_order_relaxed);
+      m_foundChildWordCount[worker.m_foundWordParents[i]].store(0, std::memory_order_relaxed);
+    }
+
+    worker.m_foundWords.clear();
+    worker.m_foundWordParents.clear();
+  }
+}
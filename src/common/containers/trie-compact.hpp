@@ -0,0 +1,370 @@
+#pragma once
+
+
+#include <common/utils.hpp>
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+
+// ----------------------------------------------------------------------------
+
+
+namespace common
+{
+  class CTrieCompactSearchContext;
+
+
+  /// Trie where each node only stores a bit mask of the letters it has
+  /// children for. All children of a node are stored next to each other, in
+  /// letter order, so the child for a letter is found by counting the bits
+  /// below it in the mask. A node is 16 bytes, where a CTriePoolOptimized is
+  /// 128 bytes.
+  ///
+  /// Words are added to a temporary builder first, and <Build> then lays out
+  /// the nodes breadth first. After that the trie is read-only.
+  class CTrieCompact
+  {
+  public:
+
+    typedef uint8_t LetterIndex_t;
+    typedef uint32_t Index_t;
+    typedef uint32_t WordId_t;
+
+    static constexpr int32_t C_CHILDREN_COUNT = ('z' - 'a') + 1;
+    static const WordId_t C_NO_WORD = ~WordId_t(0);
+
+    /// The root is always the first node
+    static const Index_t C_ROOT = 0;
+
+    struct SNode
+    {
+      /// Bit N is set if there's a child for letter N
+      uint32_t childMask;
+      Index_t firstChild;
+
+      /// Number of words in the sub tries, not counting this node's own
+      int32_t wordCount;
+      WordId_t word;
+    };
+
+    // ----------------------------------------------------------------------------
+
+
+    CTrieCompact() {}
+    CTrieCompact(const CTrieCompact&) = delete;
+    CTrieCompact& operator = (const CTrieCompact&) = delete;
+
+    void Clear();
+
+    void AddWord(const std::string_view);
+    void Build();
+
+    /// Find the child of <trie> for the letter index, or C_NO_CHILD. Any word
+    /// found is marked in the context, which is either a
+    /// CTrieCompactSearchContext or a CTrieCompactSharedSearchContext::CWorker.
+    template <class TSearchContext>
+    Index_t FindTrieWithStartingLetter(const Index_t trie, const LetterIndex_t index, TSearchContext& context) const;
+
+    template <class TSearchContext>
+    int32_t GetRemainingWords(const Index_t trie, const TSearchContext& context) const;
+
+    const SNode& GetNode(const Index_t trie) const;
+    uint32_t GetNodeCount() const;
+    uint32_t GetWordCount() const;
+
+    const char* GetWord(const WordId_t word) const;
+    uint32_t GetWordScore(const WordId_t word) const;
+
+    static LetterIndex_t GetLetterAsIndex(const char letter);
+
+    static const Index_t C_NO_CHILD = ~Index_t(0);
+
+  private:
+    struct SBuilderNode
+    {
+      std::array<Index_t, C_CHILDREN_COUNT> children;
+      WordId_t word = C_NO_WORD;
+
+      SBuilderNode() { children.fill(0); }
+    };
+
+    std::vector<SNode> m_nodes;
+
+    /// Every word as a zero terminated string, found by its offset
+    std::vector<char> m_wordText;
+    std::vector<uint32_t> m_wordOffsets;
+    std::vector<uint8_t> m_wordScores;
+
+    /// Only used while adding words. Index 0 is the root.
+    std::vector<SBuilderNode> m_builderNodes;
+  };
+
+
+  // ----------------------------------------------------------------------------
+
+
+  /// State of a single search, so the trie itself stays read-only. Only the
+  /// entries touched by a search are cleared again, so a reset is O(words
+  /// found).
+  class CTrieCompactSearchContext
+  {
+  public:
+
+    typedef CTrieCompact::Index_t Index_t;
+    typedef CTrieCompact::WordId_t WordId_t;
+
+    void Prepare(const CTrieCompact& trie);
+    void Reset();
+
+    bool IsFound(const WordId_t word) const;
+    int32_t GetFoundChildWordCount(const Index_t trie) const;
+
+    /// Returns false if the word was already found during this search
+    bool MarkFound(const WordId_t word, const Index_t parent);
+
+    const std::vector<WordId_t>& GetFoundWords() const;
+
+  private:
+    std::vector<uint8_t> m_found;
+    std::vector<int32_t> m_foundChildWordCount;
+
+    /// Found words, and the trie they were found from, for the reset
+    std::vector<WordId_t> m_foundWords;
+    std::vector<Index_t> m_foundWordParents;
+  };
+
+
+  // ----------------------------------------------------------------------------
+
+
+  /// State of a single search shared by several threads at once. Each word is
+  /// claimed by exactly one thread with an atomic flag, and that thread keeps
+  /// it in a list of its own, so the lists are never shared. The found counts
+  /// only ever grow during a search, so reading a stale one just prunes a
+  /// little less.
+  class CTrieCompactSharedSearchContext
+  {
+  public:
+
+    typedef CTrieCompact::Index_t Index_t;
+    typedef CTrieCompact::WordId_t WordId_t;
+
+    /// The part of the context used by one thread
+    class CWorker
+    {
+    public:
+
+      int32_t GetFoundChildWordCount(const Index_t trie) const;
+
+      /// Returns false if the word was already found during this search, by
+      /// any thread.
+      bool MarkFound(const WordId_t word, const Index_t parent);
+
+      /// True once every word of the trie was found, by any thread
+      bool IsEverythingFound() const;
+
+      const std::vector<WordId_t>& GetFoundWords() const;
+
+    private:
+      friend class CTrieCompactSharedSearchContext;
+
+      CTrieCompactSharedSearchContext* m_pShared = nullptr;
+
+      std::vector<WordId_t> m_foundWords;
+      std::vector<Index_t> m_foundWordParents;
+    };
+
+    CTrieCompactSharedSearchContext() {}
+    CTrieCompactSharedSearchContext(const CTrieCompactSharedSearchContext&) = delete;
+    CTrieCompactSharedSearchContext& operator = (const CTrieCompactSharedSearchContext&) = delete;
+
+    /// Must be called before searching, and not while a search is running
+    void Prepare(const CTrieCompact& trie, const uint32_t workerCount);
+    void Reset();
+
+    CWorker& GetWorker(const uint32_t index);
+    uint32_t GetWorkerCount() const;
+
+  private:
+    std::unique_ptr<std::atomic<uint8_t>[]> m_found;
+    std::unique_ptr<std::atomic<int32_t>[]> m_foundChildWordCount;
+    uint32_t m_wordCount = 0;
+    std::atomic<int32_t> m_remainingWordCount{ 0 };
+    uint32_t m_nodeCount = 0;
+
+    std::vector<CWorker> m_workers;
+  };
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+template <class TSearchContext>
+inline common::CTrieCompact::Index_t common::CTrieCompact::FindTrieWithStartingLetter(const Index_t trie, const LetterIndex_t index, TSearchContext& context) const
+{
+  assert(index < C_CHILDREN_COUNT);
+
+  const SNode& node = m_nodes[trie];
+
+  const uint32_t letterBit = 1u << index;
+  if (!(node.childMask & letterBit))
+  {
+    return C_NO_CHILD;
+  }
+
+  const Index_t childIndex = node.firstChild + PopCount(node.childMask & (letterBit - 1));
+
+  const WordId_t childWord = m_nodes[childIndex].word;
+  if (childWord != C_NO_WORD)
+  {
+    context.MarkFound(childWord, trie);
+  }
+
+  return childIndex;
+}
+
+
+template <class TSearchContext>
+inline int32_t common::CTrieCompact::GetRemainingWords(const Index_t trie, const TSearchContext& context) const
+{
+  return m_nodes[trie].wordCount - context.GetFoundChildWordCount(trie);
+}
+
+
+inline const common::CTrieCompact::SNode& common::CTrieCompact::GetNode(const Index_t trie) const
+{
+  return m_nodes[trie];
+}
+
+
+inline uint32_t common::CTrieCompact::GetNodeCount() const
+{
+  return static_cast<uint32_t>(m_nodes.size());
+}
+
+
+inline uint32_t common::CTrieCompact::GetWordCount() const
+{
+  return static_cast<uint32_t>(m_wordOffsets.size());
+}
+
+
+inline const char* common::CTrieCompact::GetWord(const WordId_t word) const
+{
+  return &m_wordText[m_wordOffsets[word]];
+}
+
+
+inline uint32_t common::CTrieCompact::GetWordScore(const WordId_t word) const
+{
+  return m_wordScores[word];
+}
+
+
+inline common::CTrieCompact::LetterIndex_t common::CTrieCompact::GetLetterAsIndex(const char letter)
+{
+  const auto result = letter - 'a';
+
+  assert(result < C_CHILDREN_COUNT);
+
+  return result;
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+inline bool common::CTrieCompactSearchContext::IsFound(const WordId_t word) const
+{
+  return m_found[word] != 0;
+}
+
+
+inline int32_t common::CTrieCompactSearchContext::GetFoundChildWordCount(const Index_t trie) const
+{
+  return m_foundChildWordCount[trie];
+}
+
+
+inline bool common::CTrieCompactSearchContext::MarkFound(const WordId_t word, const Index_t parent)
+{
+  if (m_found[word])
+  {
+    return false;
+  }
+
+  m_found[word] = 1;
+  m_foundChildWordCount[parent]++;
+
+  m_foundWords.push_back(word);
+  m_foundWordParents.push_back(parent);
+
+  return true;
+}
+
+
+inline const std::vector<common::CTrieCompactSearchContext::WordId_t>& common::CTrieCompactSearchContext::GetFoundWords() const
+{
+  return m_foundWords;
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+inline int32_t common::CTrieCompactSharedSearchContext::CWorker::GetFoundChildWordCount(const Index_t trie) const
+{
+  return m_pShared->m_foundChildWordCount[trie].load(std::memory_order_relaxed);
+}
+
+
+inline bool common::CTrieCompactSharedSearchContext::CWorker::MarkFound(const WordId_t word, const Index_t parent)
+{
+  std::atomic<uint8_t>& found = m_pShared->m_found[word];
+
+  /// A plain read first, as most words are found many times over
+  if (found.load(std::memory_order_relaxed) || found.exchange(1, std::memory_order_relaxed))
+  {
+    return false;
+  }
+
+  m_pShared->m_foundChildWordCount[parent].fetch_add(1, std::memory_order_relaxed);
+  m_pShared->m_remainingWordCount.fetch_sub(1, std::memory_order_relaxed);
+
+  m_foundWords.push_back(word);
+  m_foundWordParents.push_back(parent);
+
+  return true;
+}
+
+
+inline bool common::CTrieCompactSharedSearchContext::CWorker::IsEverythingFound() const
+{
+  return m_pShared->m_remainingWordCount.load(std::memory_order_relaxed) <= 0;
+}
+
+
+inline const std::vector<common::CTrieCompactSharedSearchContext::WordId_t>& common::CTrieCompactSharedSearchContext::CWorker::GetFoundWords() const
+{
+  return m_foundWords;
+}
+
+
+inline common::CTrieCompactSharedSearchContext::CWorker& common::CTrieCompactSharedSearchContext::GetWorker(const uint32_t index)
+{
+  return m_workers[index];
+}
+
+
+inline uint32_t common::CTrieCompactSharedSearchContext::GetWorkerCount() const
+{
+  return static_cast<uint32_t>(m_workers.size());
+}
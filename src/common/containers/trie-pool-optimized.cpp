@@ -1,163 +1,688 @@
-#include "trie-pool-optimized.hpp"
-
-
-// ----------------------------------------------------------------------------
-
-#define ROTA_USE_CUSTOM_ALLOCATOR 1
-
-// ----------------------------------------------------------------------------
-
-
-/// Note: Could also have used "__declspec(selectany)" in the header, but this is
-/// more cross-platform.
-#if defined(_DEBUG)
-
-  int32_t common::CTriePoolOptimized::s_instanceCount = 0;
-
-#endif
-
-
-// ----------------------------------------------------------------------------
-
-
-namespace common
-{
-  namespace details
-  {
-    class CTriePoolOptimizedAllocator
-    {
-    public:
-
-      CTriePoolOptimizedAllocator();
-      ~CTriePoolOptimizedAllocator();
-
-      CTriePoolOptimized::Index_t AllocateTrie(CTriePoolOptimized::Index_t parent);
-      void FreeAll();
-
-      CTriePoolOptimized* GetPtrFromIndex(const CTriePoolOptimized::Index_t index);
-      CTriePoolOptimized::Index_t GetIndexFromPtr(const CTriePoolOptimized*);
-
-    private:
-      static const size_t C_SSE_ALIGNMENT = 16;
-      static const size_t C_TRIE_SIZE = common::AlignUpTo(sizeof(CTriePoolOptimized), C_SSE_ALIGNMENT);
-      static const size_t C_PREALLOCATED_INSTANCE_COUNT = 600 * 1000;
-
-      uint8_t* m_pMem = nullptr;
-      uint8_t* m_pAlignedMem = nullptr;
-      uint32_t m_freeCount = C_PREALLOCATED_INSTANCE_COUNT;
-      volatile long m_instanceCount = 1;
-
-#if defined(_DEBUG)
-      const size_t m_debugTrieSize = C_TRIE_SIZE;
-      CTriePoolOptimized* m_pDebugTriesArray = nullptr;
-#endif
-    };
-  }
-}
-
-
-// ----------------------------------------------------------------------------
-
-
-/*static*/ common::details::CTriePoolOptimizedAllocator* g_pTriePoolOptimizedAllocator = nullptr;
-
-
-// ----------------------------------------------------------------------------
-
-
-common::details::CTriePoolOptimizedAllocator::CTriePoolOptimizedAllocator()
-{
-  m_pMem = new uint8_t[(C_PREALLOCATED_INSTANCE_COUNT * C_TRIE_SIZE) + C_CACHE_SIZE];
-
-  m_pAlignedMem = common::AlignUpToPtr(m_pMem, C_CACHE_SIZE);
-
-#if defined(_DEBUG)
-  m_pDebugTriesArray = reinterpret_cast<CTriePoolOptimized*>(m_pAlignedMem);
-#endif
-}
-
-
-common::details::CTriePoolOptimizedAllocator::~CTriePoolOptimizedAllocator()
-{
-  FreeAll();
-}
-
-
-common::CTriePoolOptimized::Index_t common::details::CTriePoolOptimizedAllocator::AllocateTrie(CTriePoolOptimized::Index_t parent)
-{
-  const uint32_t indexToUse = m_instanceCount;
-
-  assert(indexToUse < C_PREALLOCATED_INSTANCE_COUNT);
-
-  void* pMemForTrie = &m_pAlignedMem[indexToUse * C_TRIE_SIZE];
-
-  common::InterlockedIncrement(&m_instanceCount);
-
-  new (pMemForTrie) CTriePoolOptimized(parent);
-
-  return indexToUse;
-}
-
-
-void common::details::CTriePoolOptimizedAllocator::FreeAll()
-{
-  m_instanceCount = 0;
-
-  delete[] m_pMem;
-  m_pMem = nullptr;
-}
-
-
-common::CTriePoolOptimized* common::details::CTriePoolOptimizedAllocator::GetPtrFromIndex(const CTriePoolOptimized::Index_t index)
-{
-  void* pMemForTrie = &m_pAlignedMem[index * C_TRIE_SIZE];
-
-  return reinterpret_cast<common::CTriePoolOptimized*>(pMemForTrie);
-}
-
-
-common::CTriePoolOptimized::Index_t common::details::CTriePoolOptimizedAllocator::GetIndexFromPtr(const CTriePoolOptimized* pTrie)
-{
-  const uintptr_t diff = uintptr_t(pTrie) - uintptr_t(m_pAlignedMem);
-
-  const CTriePoolOptimized::Index_t result = static_cast<CTriePoolOptimized::Index_t>(diff / C_TRIE_SIZE);
-
-  return result;
-}
-
-
-// ----------------------------------------------------------------------------
-
-
-void common::CTriePoolOptimized::InitializePool()
-{
-  if (!g_pTriePoolOptimizedAllocator)
-  {
-    g_pTriePoolOptimizedAllocator = new details::CTriePoolOptimizedAllocator();
-  }
-}
-
-
-void common::CTriePoolOptimized::ClearAllTries()
-{
-  delete g_pTriePoolOptimizedAllocator;
-  g_pTriePoolOptimizedAllocator = nullptr;
-}
-
-
-common::CTriePoolOptimized::Index_t common::CTriePoolOptimized::AllocateTrie(const CTriePoolOptimized::Index_t parent)
-{
-  return g_pTriePoolOptimizedAllocator->AllocateTrie(parent);
-}
-
-
-common::CTriePoolOptimized* common::CTriePoolOptimized::GetPtrFromIndex(CTriePoolOptimized::Index_t index)
-{
-  return g_pTriePoolOptimizedAllocator->GetPtrFromIndex(index);
-}
-
-
-common::CTriePoolOptimized::Index_t common::CTriePoolOptimized::GetIndexFromPtr(CTriePoolOptimized* pTrie)
-{
-  return g_pTriePoolOptimizedAllocator->GetIndexFromPtr(pTrie);
-}
+#include "trie-pool-optimized.hpp"
+
+#include <common/containers/chunked-arena.hpp>
+#include <common/io/mapped-file.hpp>
+
+#include <cstddef>
+#include <fstream>
+#include <new>
+
+
+// ----------------------------------------------------------------------------
+
+#define ROTA_USE_CUSTOM_ALLOCATOR 1
+
+#ifndef ROTA_USE_HUGE_PAGES
+  #define ROTA_USE_HUGE_PAGES 1
+#endif
+
+// ----------------------------------------------------------------------------
+
+
+/// Note: Could also have used "__declspec(selectany)" in the header, but this is
+/// more cross-platform.
+#if defined(_DEBUG)
+
+  int32_t common::CTriePoolOptimized::s_instanceCount = 0;
+
+#endif
+
+
+// ----------------------------------------------------------------------------
+
+
+namespace common
+{
+  namespace details
+  {
+    class CTriePoolOptimizedAllocator
+    {
+    public:
+
+      CTriePoolOptimizedAllocator();
+      ~CTriePoolOptimizedAllocator();
+
+      CTriePoolOptimized::Index_t AllocateTrie(CTriePoolOptimized::Index_t parent);
+      CTriePoolOptimized::Index_t ReserveTries(const uint32_t count);
+      void FreeAll();
+
+      CTriePoolOptimized* GetPtrFromIndex(const CTriePoolOptimized::Index_t index);
+      CTriePoolOptimized::Index_t GetIndexFromPtr(const CTriePoolOptimized*);
+
+      CTriePoolOptimized::Index_t& GetParent(const CTriePoolOptimized::Index_t index);
+
+      CTriePoolOptimized::WordId_t AllocateWord();
+      char* GetWord(const CTriePoolOptimized::WordId_t word);
+
+      uint32_t GetAllocatedTrieCount() const;
+      SArenaUsage GetUsage() const;
+
+      bool SaveImage(const char* path, const std::vector<CTriePoolOptimized::Index_t>& roots) const;
+      bool LoadImage(const char* path, std::vector<CTriePoolOptimized::Index_t>& rootsOut);
+
+    private:
+      static const size_t C_SSE_ALIGNMENT = 16;
+      static const size_t C_TRIE_SIZE = common::AlignUpTo(sizeof(CTriePoolOptimized), C_SSE_ALIGNMENT);
+      static const size_t C_WORD_SIZE = CTriePoolOptimized::C_MAX_WORD_LENGTH + 1;
+
+      /// Only address space is reserved for these, and memory is committed as
+      /// the tries are allocated.
+      static const size_t C_MAX_INSTANCE_COUNT = (sizeof(void*) == 8) ? (64 * 1024 * 1024) : (4 * 1024 * 1024);
+
+      CChunkedArena m_arena;
+      uint8_t* m_pAlignedMem = nullptr;
+      volatile long m_instanceCount = 1;
+
+      /// Cold data, indexed by trie and word id respectively
+      CChunkedArena m_parentArena;
+      CTriePoolOptimized::Index_t* m_pParents = nullptr;
+
+      CChunkedArena m_wordArena;
+      char* m_pWords = nullptr;
+      volatile long m_wordCount = 1;
+
+      /// Set when the tries come from a compiled image, which is read-only
+      CMappedFile m_mappedImage;
+
+#if defined(_DEBUG)
+      const size_t m_debugTrieSize = C_TRIE_SIZE;
+      CTriePoolOptimized* m_pDebugTriesArray = nullptr;
+#endif
+    };
+  }
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+/*static*/ common::details::CTriePoolOptimizedAllocator* g_pTriePoolOptimizedAllocator = nullptr;
+
+
+#if !defined(_DEBUG)
+  static_assert(sizeof(common::CTriePoolOptimized) == sizeof(uint32_t) * (common::CTriePoolOptimized::C_CHILDREN_COUNT + 3), "Only the fields needed while searching belong in the trie");
+#endif
+
+
+// ----------------------------------------------------------------------------
+
+
+namespace
+{
+  ///
+  /// Layout of a compiled dictionary image:
+  ///
+  ///   SCompiledDictionaryHeader
+  ///   Index_t roots[rootCount]
+  ///   <padding up to a multiple of C_CACHE_SIZE>
+  ///   CTriePoolOptimized tries[trieCount], each taking trieSize bytes
+  ///   Index_t parents[trieCount]
+  ///   <padding up to a multiple of C_CACHE_SIZE>
+  ///   char words[wordCount][wordSize]
+  ///
+  /// Tries only refer to each other by index, so the image is relocatable and
+  /// can be used straight from the mapping. The checksum covers everything
+  /// after the header. Images are written in the native byte order.
+  ///
+  struct SCompiledDictionaryHeader
+  {
+    char magic[8];
+    uint32_t version;
+    uint32_t trieSize;
+    uint32_t trieCount;
+    uint32_t rootCount;
+    uint32_t wordCount;
+    uint32_t wordSize;
+    uint64_t checksum;
+  };
+
+  static_assert(sizeof(SCompiledDictionaryHeader) % sizeof(uint64_t) == 0, "The checksum expects 8 byte blocks after the header");
+
+  const char C_COMPILED_DICTIONARY_MAGIC[8] = { 'R', 'O', 'T', 'A', 'T', 'R', 'I', 'E' };
+  const uint32_t C_COMPILED_DICTIONARY_VERSION = 3;
+
+
+  size_t GetCompiledDictionaryTriesOffset(const uint32_t rootCount)
+  {
+    return common::AlignUpTo(sizeof(SCompiledDictionaryHeader) + (rootCount * sizeof(common::CTriePoolOptimized::Index_t)), common::C_CACHE_SIZE);
+  }
+
+
+  size_t GetCompiledDictionaryParentsSize(const uint32_t trieCount)
+  {
+    return common::AlignUpTo(trieCount * sizeof(common::CTriePoolOptimized::Index_t), common::C_CACHE_SIZE);
+  }
+
+
+  /// Not cryptographic, just a fast way to detect a damaged image. Works on
+  /// 8 bytes at a time, so checking a big dictionary stays cheap.
+  uint64_t UpdateChecksum(uint64_t checksum, const uint8_t* pData, const size_t size)
+  {
+    static const uint64_t C_PRIME = 0x100000001b3ull;
+
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+    {
+      uint64_t value;
+      memcpy(&value, pData + i, sizeof(value));
+
+      checksum = (checksum ^ value) * C_PRIME;
+    }
+
+    for (; i < size; i++)
+    {
+      checksum = (checksum ^ pData[i]) * C_PRIME;
+    }
+
+    return checksum;
+  }
+
+
+  const uint64_t C_CHECKSUM_SEED = 0xcbf29ce484222325ull;
+
+
+  /// True if every root, child, parent and word id of the image refers to a
+  /// trie or word inside of it, the parents match the children, and every
+  /// word is null terminated
+  bool IsCompiledDictionaryInRange(
+    const SCompiledDictionaryHeader& header,
+    const std::vector<common::CTriePoolOptimized::Index_t>& roots,
+    const uint8_t* pTries,
+    const uint8_t* pParents,
+    const uint8_t* pWords)
+  {
+    static const uint32_t C_VALID_CHILD_MASK = (uint32_t(1) << common::CTriePoolOptimized::C_CHILDREN_COUNT) - 1;
+
+    const auto getParent = [&](const common::CTriePoolOptimized::Index_t trie)
+    {
+      common::CTriePoolOptimized::Index_t result;
+      memcpy(&result, pParents + (size_t(trie) * sizeof(result)), sizeof(result));
+
+      return result;
+    };
+
+    ///
+    /// Found words walk up the parents until they reach 0. Every child having
+    /// its owner as parent, and every root having none, means such a walk
+    /// retraces the path down from a root, and can't go round in a cycle.
+    ///
+    for (const common::CTriePoolOptimized::Index_t root : roots)
+    {
+      if (root >= header.trieCount || getParent(root) != 0)
+      {
+        return false;
+      }
+    }
+
+    for (uint32_t trie = 0; trie < header.trieCount; trie++)
+    {
+      const common::CTriePoolOptimized* pTrie = reinterpret_cast<const common::CTriePoolOptimized*>(pTries + (size_t(trie) * header.trieSize));
+
+      if (getParent(trie) >= header.trieCount || pTrie->GetWordId() >= header.wordCount || (pTrie->GetChildMask() & ~C_VALID_CHILD_MASK))
+      {
+        return false;
+      }
+
+      /// Trie 0 means "no child", so it can't have any itself
+      if (trie == 0 && pTrie->GetChildMask())
+      {
+        return false;
+      }
+
+      ///
+      /// The search follows the mask, so a child has to be there for exactly
+      /// the letters in it
+      ///
+      for (common::CTriePoolOptimized::LetterIndex_t letter = 0; letter < common::CTriePoolOptimized::C_CHILDREN_COUNT; letter++)
+      {
+        const common::CTriePoolOptimized::Index_t child = pTrie->GetChild(letter);
+        const bool hasChildBit = (pTrie->GetChildMask() >> letter) & 1;
+
+        if (child >= header.trieCount || bool(child) != hasChildBit || (child && getParent(child) != trie))
+        {
+          return false;
+        }
+      }
+    }
+
+    for (uint32_t word = 0; word < header.wordCount; word++)
+    {
+      if (pWords[(size_t(word) * header.wordSize) + header.wordSize - 1])
+      {
+        return false;
+      }
+    }
+
+    return true;
+  }
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+common::details::CTriePoolOptimizedAllocator::CTriePoolOptimizedAllocator()
+{
+  if (!m_arena.Initialize(C_TRIE_SIZE, C_MAX_INSTANCE_COUNT, ROTA_USE_HUGE_PAGES != 0))
+  {
+    throw std::bad_alloc();
+  }
+
+  if (!m_parentArena.Initialize(sizeof(CTriePoolOptimized::Index_t), C_MAX_INSTANCE_COUNT, false) ||
+    !m_wordArena.Initialize(C_WORD_SIZE, C_MAX_INSTANCE_COUNT, false))
+  {
+    throw std::bad_alloc();
+  }
+
+  m_pAlignedMem = m_arena.GetBase();
+  m_pParents = reinterpret_cast<CTriePoolOptimized::Index_t*>(m_parentArena.GetBase());
+  m_pWords = reinterpret_cast<char*>(m_wordArena.GetBase());
+
+  /// Index 0 is reserved to mean "no trie" and "no word", but it should still
+  /// be backed
+  m_arena.EnsureCapacity(m_instanceCount);
+  m_parentArena.EnsureCapacity(m_instanceCount);
+  m_wordArena.EnsureCapacity(m_wordCount);
+
+#if defined(_DEBUG)
+  m_pDebugTriesArray = reinterpret_cast<CTriePoolOptimized*>(m_pAlignedMem);
+#endif
+}
+
+
+common::details::CTriePoolOptimizedAllocator::~CTriePoolOptimizedAllocator()
+{
+  FreeAll();
+}
+
+
+common::CTriePoolOptimized::Index_t common::details::CTriePoolOptimizedAllocator::AllocateTrie(CTriePoolOptimized::Index_t parent)
+{
+  assert(!m_mappedImage.GetData() && "Tries loaded from a compiled image are read-only");
+
+  const uint32_t indexToUse = common::InterlockedIncrement(&m_instanceCount) - 1;
+
+  m_arena.EnsureCapacity(size_t(indexToUse) + 1);
+  m_parentArena.EnsureCapacity(size_t(indexToUse) + 1);
+
+  void* pMemForTrie = &m_pAlignedMem[indexToUse * C_TRIE_SIZE];
+
+  new (pMemForTrie) CTriePoolOptimized();
+  m_pParents[indexToUse] = parent;
+
+  return indexToUse;
+}
+
+
+common::CTriePoolOptimized::Index_t common::details::CTriePoolOptimizedAllocator::ReserveTries(const uint32_t count)
+{
+  assert(!m_mappedImage.GetData() && "Tries loaded from a compiled image are read-only");
+
+  const uint32_t firstIndex = common::InterlockedAdd(&m_instanceCount, count) - count;
+
+  m_arena.EnsureCapacity(size_t(firstIndex) + count);
+  m_parentArena.EnsureCapacity(size_t(firstIndex) + count);
+
+  return firstIndex;
+}
+
+
+void common::details::CTriePoolOptimizedAllocator::FreeAll()
+{
+  m_instanceCount = 0;
+  m_wordCount = 0;
+
+  m_arena.Release();
+  m_parentArena.Release();
+  m_wordArena.Release();
+
+  m_mappedImage.Close();
+  m_pAlignedMem = nullptr;
+  m_pParents = nullptr;
+  m_pWords = nullptr;
+}
+
+
+common::CTriePoolOptimized* common::details::CTriePoolOptimizedAllocator::GetPtrFromIndex(const CTriePoolOptimized::Index_t index)
+{
+  void* pMemForTrie = &m_pAlignedMem[index * C_TRIE_SIZE];
+
+  return reinterpret_cast<common::CTriePoolOptimized*>(pMemForTrie);
+}
+
+
+common::CTriePoolOptimized::Index_t common::details::CTriePoolOptimizedAllocator::GetIndexFromPtr(const CTriePoolOptimized* pTrie)
+{
+  const uintptr_t diff = uintptr_t(pTrie) - uintptr_t(m_pAlignedMem);
+
+  const CTriePoolOptimized::Index_t result = static_cast<CTriePoolOptimized::Index_t>(diff / C_TRIE_SIZE);
+
+  return result;
+}
+
+
+common::CTriePoolOptimized::Index_t& common::details::CTriePoolOptimizedAllocator::GetParent(const CTriePoolOptimized::Index_t index)
+{
+  return m_pParents[index];
+}
+
+
+common::CTriePoolOptimized::WordId_t common::details::CTriePoolOptimizedAllocator::AllocateWord()
+{
+  assert(!m_mappedImage.GetData() && "Words loaded from a compiled image are read-only");
+
+  const uint32_t wordToUse = common::InterlockedIncrement(&m_wordCount) - 1;
+
+  m_wordArena.EnsureCapacity(size_t(wordToUse) + 1);
+
+  return wordToUse;
+}
+
+
+char* common::details::CTriePoolOptimizedAllocator::GetWord(const CTriePoolOptimized::WordId_t word)
+{
+  return &m_pWords[word * C_WORD_SIZE];
+}
+
+
+uint32_t common::details::CTriePoolOptimizedAllocator::GetAllocatedTrieCount() const
+{
+  return static_cast<uint32_t>(m_instanceCount);
+}
+
+
+common::SArenaUsage common::details::CTriePoolOptimizedAllocator::GetUsage() const
+{
+  SArenaUsage result;
+  result.usedCount = GetAllocatedTrieCount();
+
+  if (m_mappedImage.GetData())
+  {
+    result.capacityCount = result.usedCount;
+    result.maxCount = result.usedCount;
+  }
+  else
+  {
+    result.capacityCount = m_arena.GetCapacity();
+    result.maxCount = m_arena.GetMaxCount();
+    result.committedBytes = m_arena.GetCommittedBytes();
+  }
+
+  return result;
+}
+
+
+bool common::details::CTriePoolOptimizedAllocator::SaveImage(const char* path, const std::vector<CTriePoolOptimized::Index_t>& roots) const
+{
+  std::ofstream fileStream(path, std::ofstream::binary | std::ofstream::trunc);
+  if (!fileStream)
+  {
+    return false;
+  }
+
+  const uint32_t trieCount = static_cast<uint32_t>(m_instanceCount);
+  const uint32_t rootCount = static_cast<uint32_t>(roots.size());
+  const uint32_t wordCount = static_cast<uint32_t>(m_wordCount);
+
+  ///
+  /// The roots, padded up to where the tries begin. Checksumming this as one
+  /// block keeps the 8 byte steps of the checksum identical to the ones taken
+  /// when verifying the image as a whole.
+  ///
+  std::vector<uint8_t> rootsBlock(GetCompiledDictionaryTriesOffset(rootCount) - sizeof(SCompiledDictionaryHeader), 0);
+  memcpy(rootsBlock.data(), roots.data(), rootCount * sizeof(CTriePoolOptimized::Index_t));
+
+  /// The parents, padded the same way so the words start on a cache line
+  std::vector<uint8_t> parentsBlock(GetCompiledDictionaryParentsSize(trieCount), 0);
+  memcpy(parentsBlock.data() + sizeof(CTriePoolOptimized::Index_t), m_pParents + 1, (trieCount - 1) * sizeof(CTriePoolOptimized::Index_t));
+
+  /// Index 0 is never handed out, as it means "no child" and "no word". Write
+  /// it as zeros so the same dictionary always gives the exact same image.
+  const uint8_t zeros[C_TRIE_SIZE] = {};
+
+  SCompiledDictionaryHeader header;
+  memcpy(header.magic, C_COMPILED_DICTIONARY_MAGIC, sizeof(header.magic));
+  header.version = C_COMPILED_DICTIONARY_VERSION;
+  header.trieSize = C_TRIE_SIZE;
+  header.trieCount = trieCount;
+  header.rootCount = rootCount;
+  header.wordCount = wordCount;
+  header.wordSize = C_WORD_SIZE;
+
+  uint64_t checksum = C_CHECKSUM_SEED;
+  checksum = UpdateChecksum(checksum, rootsBlock.data(), rootsBlock.size());
+  checksum = UpdateChecksum(checksum, zeros, C_TRIE_SIZE);
+  checksum = UpdateChecksum(checksum, &m_pAlignedMem[C_TRIE_SIZE], (trieCount - 1) * C_TRIE_SIZE);
+  checksum = UpdateChecksum(checksum, parentsBlock.data(), parentsBlock.size());
+  checksum = UpdateChecksum(checksum, zeros, C_WORD_SIZE);
+  checksum = UpdateChecksum(checksum, reinterpret_cast<const uint8_t*>(&m_pWords[C_WORD_SIZE]), (wordCount - 1) * C_WORD_SIZE);
+  header.checksum = checksum;
+
+  fileStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  fileStream.write(reinterpret_cast<const char*>(rootsBlock.data()), rootsBlock.size());
+  fileStream.write(reinterpret_cast<const char*>(zeros), C_TRIE_SIZE);
+  fileStream.write(reinterpret_cast<const char*>(&m_pAlignedMem[C_TRIE_SIZE]), (trieCount - 1) * C_TRIE_SIZE);
+  fileStream.write(reinterpret_cast<const char*>(parentsBlock.data()), parentsBlock.size());
+  fileStream.write(reinterpret_cast<const char*>(zeros), C_WORD_SIZE);
+  fileStream.write(&m_pWords[C_WORD_SIZE], (wordCount - 1) * C_WORD_SIZE);
+
+  return bool(fileStream);
+}
+
+
+bool common::details::CTriePoolOptimizedAllocator::LoadImage(const char* path, std::vector<CTriePoolOptimized::Index_t>& rootsOut)
+{
+  CMappedFile& image = m_mappedImage;
+
+  if (!image.Open(path, CMappedFile::EAccess::Random) || image.GetSize() < sizeof(SCompiledDictionaryHeader))
+  {
+    image.Close();
+    return false;
+  }
+
+  SCompiledDictionaryHeader header;
+  memcpy(&header, image.GetData(), sizeof(header));
+
+  const bool isValidHeader =
+    memcmp(header.magic, C_COMPILED_DICTIONARY_MAGIC, sizeof(header.magic)) == 0 &&
+    header.version == C_COMPILED_DICTIONARY_VERSION &&
+    header.trieSize == C_TRIE_SIZE &&
+    header.trieCount > 0 &&
+    header.wordSize == C_WORD_SIZE &&
+    header.wordCount > 0;
+
+  const size_t triesOffset = isValidHeader ? GetCompiledDictionaryTriesOffset(header.rootCount) : 0;
+  const size_t parentsOffset = triesOffset + (size_t(header.trieCount) * C_TRIE_SIZE);
+  const size_t wordsOffset = isValidHeader ? parentsOffset + GetCompiledDictionaryParentsSize(header.trieCount) : 0;
+
+  if (!isValidHeader || image.GetSize() != wordsOffset + (size_t(header.wordCount) * C_WORD_SIZE))
+  {
+    image.Close();
+    return false;
+  }
+
+  const uint8_t* pImage = reinterpret_cast<const uint8_t*>(image.GetData());
+
+  const uint64_t checksum = UpdateChecksum(C_CHECKSUM_SEED, pImage + sizeof(header), image.GetSize() - sizeof(header));
+  if (checksum != header.checksum)
+  {
+    image.Close();
+    return false;
+  }
+
+  rootsOut.resize(header.rootCount);
+  memcpy(rootsOut.data(), pImage + sizeof(header), header.rootCount * sizeof(CTriePoolOptimized::Index_t));
+
+  ///
+  /// A matching checksum only means the image wasn't damaged on the way, not
+  /// that whoever wrote it kept every index in range. They're used without
+  /// any checks while searching, so check them all once here.
+  ///
+  const bool isInRange = IsCompiledDictionaryInRange(
+    header,
+    rootsOut,
+    pImage + triesOffset,
+    pImage + parentsOffset,
+    pImage + wordsOffset);
+
+  if (!isInRange)
+  {
+    rootsOut.clear();
+    image.Close();
+    return false;
+  }
+
+  ///
+  /// No need for the arenas anymore, as everything is used directly from
+  /// the mapping. The mapping is page aligned, and the offsets are multiples
+  /// of the cache size, so the alignment is the same.
+  ///
+  m_arena.Release();
+  m_parentArena.Release();
+  m_wordArena.Release();
+
+  m_pAlignedMem = const_cast<uint8_t*>(pImage + triesOffset);
+  m_pParents = reinterpret_cast<CTriePoolOptimized::Index_t*>(const_cast<uint8_t*>(pImage + parentsOffset));
+  m_pWords = reinterpret_cast<char*>(const_cast<uint8_t*>(pImage + wordsOffset));
+  m_instanceCount = header.trieCount;
+  m_wordCount = header.wordCount;
+
+#if defined(_DEBUG)
+  m_pDebugTriesArray = reinterpret_cast<CTriePoolOptimized*>(m_pAlignedMem);
+#endif
+
+  return true;
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void common::CTriePoolOptimized::InitializePool()
+{
+  if (!g_pTriePoolOptimizedAllocator)
+  {
+    g_pTriePoolOptimizedAllocator = new details::CTriePoolOptimizedAllocator();
+  }
+}
+
+
+void common::CTriePoolOptimized::ClearAllTries()
+{
+  delete g_pTriePoolOptimizedAllocator;
+  g_pTriePoolOptimizedAllocator = nullptr;
+}
+
+
+common::CTriePoolOptimized::Index_t common::CTriePoolOptimized::AllocateTrie(const CTriePoolOptimized::Index_t parent)
+{
+  return g_pTriePoolOptimizedAllocator->AllocateTrie(parent);
+}
+
+
+common::CTriePoolOptimized::Index_t common::CTriePoolOptimized::ReserveTries(const uint32_t count)
+{
+  return g_pTriePoolOptimizedAllocator->ReserveTries(count);
+}
+
+
+common::CTriePoolOptimized* common::CTriePoolOptimized::GetPtrFromIndex(CTriePoolOptimized::Index_t index)
+{
+  return g_pTriePoolOptimizedAllocator->GetPtrFromIndex(index);
+}
+
+
+common::CTriePoolOptimized::Index_t common::CTriePoolOptimized::GetIndexFromPtr(const CTriePoolOptimized* pTrie)
+{
+  return g_pTriePoolOptimizedAllocator->GetIndexFromPtr(pTrie);
+}
+
+
+uint32_t common::CTriePoolOptimized::GetAllocatedTrieCount()
+{
+  return g_pTriePoolOptimizedAllocator->GetAllocatedTrieCount();
+}
+
+
+common::CTriePoolOptimized::Index_t common::CTriePoolOptimized::GetParent(const Index_t trie)
+{
+  return g_pTriePoolOptimizedAllocator->GetParent(trie);
+}
+
+
+const char* common::CTriePoolOptimized::GetWord(const WordId_t word)
+{
+  return g_pTriePoolOptimizedAllocator->GetWord(word);
+}
+
+
+void common::CTriePoolOptimized::SetParent(const Index_t trie, const Index_t parent)
+{
+  g_pTriePoolOptimizedAllocator->GetParent(trie) = parent;
+}
+
+
+common::CTriePoolOptimized::WordId_t common::CTriePoolOptimized::AllocateWord(char*& pTextOut)
+{
+  const WordId_t result = g_pTriePoolOptimizedAllocator->AllocateWord();
+
+  pTextOut = g_pTriePoolOptimizedAllocator->GetWord(result);
+
+  return result;
+}
+
+
+char* common::CTriePoolOptimized::GetWordBuffer(const WordId_t word)
+{
+  return g_pTriePoolOptimizedAllocator->GetWord(word);
+}
+
+
+common::SArenaUsage common::CTriePoolOptimized::GetPoolUsage()
+{
+  if (!g_pTriePoolOptimizedAllocator)
+  {
+    return SArenaUsage();
+  }
+
+  return g_pTriePoolOptimizedAllocator->GetUsage();
+}
+
+
+bool common::CTriePoolOptimized::SaveCompiledDictionary(const char* path, const std::vector<Index_t>& roots)
+{
+#if defined(_DEBUG)
+  /// The debug members are raw pointers, which makes the tries non-relocatable
+  return false;
+#else
+  if (!g_pTriePoolOptimizedAllocator)
+  {
+    return false;
+  }
+
+  return g_pTriePoolOptimizedAllocator->SaveImage(path, roots);
+#endif
+}
+
+
+bool common::CTriePoolOptimized::LoadCompiledDictionary(const char* path, std::vector<Index_t>& rootsOut)
+{
+#if defined(_DEBUG)
+  /// The debug members are raw pointers, which makes the tries non-relocatable
+  return false;
+#else
+  ClearAllTries();
+  InitializePool();
+
+  if (!g_pTriePoolOptimizedAllocator->LoadImage(path, rootsOut))
+  {
+    /// Leave an empty, usable pool behind
+    ClearAllTries();
+    InitializePool();
+
+    return false;
+  }
+
+  return true;
+#endif
+}
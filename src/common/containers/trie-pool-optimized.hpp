@@ -1,327 +1,546 @@
-#pragma once
-
-
-#include <common/utils.hpp>
-
-#include <array>
-#include <cassert>
-#include <cstdint>
-
-#include <string>
-
-#if defined(_DEBUG)
-  #include <iostream>
-#endif
-
-//TODO: Board should be in letter-format as well
-
-// ----------------------------------------------------------------------------
-
-
-namespace common
-{
-  class CTriePoolOptimized
-  {
-  public:
-
-    typedef uint8_t LetterIndex_t;
-    typedef uint32_t Index_t;
-
-    static constexpr int32_t C_CHILDREN_COUNT = ('z' - 'a') + 1;
-    static const uint32_t C_MAX_WORD_LENGTH = 15;
-
-    // ----------------------------------------------------------------------------
-
-
-    CTriePoolOptimized(const Index_t parent = 0);
-    CTriePoolOptimized(const CTriePoolOptimized&) = delete;
-    CTriePoolOptimized(CTriePoolOptimized&&) = delete;
-    ~CTriePoolOptimized();
-
-    CTriePoolOptimized& operator = (const CTriePoolOptimized&) = delete;
-    CTriePoolOptimized& operator = (CTriePoolOptimized&&) = delete;
-
-    void AddWord(const std::string&);
-
-    /// Find the next Trie according to the letter index
-    Index_t FindTrieWithStartingLetter(const LetterIndex_t index, CTriePoolOptimized& parentTrie);
-
-    int32_t GetRemainingWords() const;
-
-    void DumpToScreen() const;
-
-    static void InitializePool();
-    static void ClearAllTries();
-
-    static Index_t AllocateTrie(Index_t parent = 0);
-
-    static CTriePoolOptimized* GetPtrFromIndex(Index_t index);
-    static CTriePoolOptimized::Index_t GetIndexFromPtr(CTriePoolOptimized*);
-
-    static LetterIndex_t GetLetterAsIndex(const char letter);
-    static char GetIndexAsLetter(const LetterIndex_t letter);
-
-    static void GetFoundWords(const CTriePoolOptimized& currentTrie, TContainerWriter<const char*>& wordList, uint32_t& scoreOutput);
-    static uint32_t GetFoundWordsSize(const CTriePoolOptimized& currentTrie);
-
-    static uint32_t GetScoreForWordLength(const size_t wordLength);
-
-  private:
-    std::array<Index_t, C_CHILDREN_COUNT> m_children;
-
-    const Index_t m_parent;
-
-    int32_t m_wordCount : 31;
-    int32_t m_found : 1;
-
-    char m_word[C_MAX_WORD_LENGTH + 1];
-
-#if defined(_DEBUG)
-    CTriePoolOptimized* m_debugParent = nullptr;
-    std::array<CTriePoolOptimized*, C_CHILDREN_COUNT> m_debugChildren;
-    Index_t m_DebugMyId = 0;
-    static int32_t s_instanceCount;
-#endif
-  };
-}
-
-
-// ----------------------------------------------------------------------------
-
-
-inline common::CTriePoolOptimized::CTriePoolOptimized(const Index_t parent)
-  : m_parent(parent)
-  , m_wordCount(0)
-  , m_found(false)
-{
-  m_children.fill(0);
-  m_word[0] = '\0';
-
-#if defined(_DEBUG)
-  m_debugParent = GetPtrFromIndex(parent);
-  m_debugChildren.fill(nullptr);
-  m_DebugMyId = GetIndexFromPtr(this);
-  s_instanceCount++;
-#endif
-}
-
-
-inline common::CTriePoolOptimized::~CTriePoolOptimized()
-{
-#if defined(_DEBUG)
-  s_instanceCount--;
-#endif
-}
-
-
-inline void common::CTriePoolOptimized::AddWord(const std::string& word)
-{
-  CTriePoolOptimized* pCurrentTrie = this;
-  Index_t currentAsIndex = GetIndexFromPtr(pCurrentTrie);
-
-  assert(GetPtrFromIndex(currentAsIndex) == pCurrentTrie);
-
-  for (size_t i = 0; i < word.length(); i++)
-  {
-    const char currentLetter = word[i];
-    const auto currentIndex = GetLetterAsIndex(currentLetter);
-
-    if (currentLetter == 'q' && word[i + 1] == 'u')
-    {
-      i++;
-    }
-
-    pCurrentTrie->m_wordCount++;
-
-    const Index_t childIndex = pCurrentTrie->m_children[currentIndex];
-    if (childIndex)
-    {
-      CTriePoolOptimized* pChildTrie = GetPtrFromIndex(childIndex);
-
-      assert(pChildTrie != pCurrentTrie);
-
-#if defined(_DEBUG)
-      assert(pChildTrie == pCurrentTrie->m_debugChildren.at(currentIndex));
-#endif
-
-      pCurrentTrie = pChildTrie;
-    }
-    else
-    {
-      const Index_t newChildIndex = AllocateTrie(currentAsIndex);
-
-      pCurrentTrie->m_children[currentIndex] = newChildIndex;
-
-#if defined(_DEBUG)
-      pCurrentTrie->m_debugChildren.at(currentIndex) = GetPtrFromIndex(newChildIndex);
-#endif
-
-      /// Next trie in the word-chain ...
-      pCurrentTrie = GetPtrFromIndex(newChildIndex);
-      currentAsIndex = newChildIndex;
-    }
-  }
-
-  /// Add the actual word to the end trie
-  //TODO: Just calculate the word from the children.
-  assert(word.length() < sizeof(m_word));
-  strcpy(pCurrentTrie->m_word, word.c_str());
-}
-
-
-inline common::CTriePoolOptimized::Index_t common::CTriePoolOptimized::FindTrieWithStartingLetter(const LetterIndex_t index, CTriePoolOptimized& parentTrie)
-{
-  assert(index < C_CHILDREN_COUNT);
-
-  const Index_t childIndex = parentTrie.m_children[index];
-  if (!childIndex)
-  {
-    return 0;
-  }
-
-  CTriePoolOptimized* pCurrentTrie = GetPtrFromIndex(childIndex);
-
-  if (pCurrentTrie->m_word[0] && !pCurrentTrie->m_found)
-  {
-    assert(parentTrie.m_wordCount);
-
-    parentTrie.m_wordCount--;
-
-    pCurrentTrie->m_found = true;
-  }
-
-  return childIndex;
-}
-
-
-inline int32_t common::CTriePoolOptimized::GetRemainingWords() const
-{
-  return m_wordCount;
-}
-
-
-inline void common::CTriePoolOptimized::DumpToScreen() const
-{
-#if defined(_DEBUG)
-  std::cout << "Trie stats:" << std::endl;
-  std::cout << "\tWord count: " << m_wordCount << std::endl;
-
-  for (LetterIndex_t i = 0; i < C_CHILDREN_COUNT; i++)
-  {
-    if (!m_children[i])
-    {
-      continue;
-    }
-
-    //std::cout << "\tLetter " << int32_t(i) << " is " << GetIndexAsLetter(i) << " has word count: " << m_children[i]->m_wordCount << std::endl;
-  }
-
-#endif
-}
-
-
-inline common::CTriePoolOptimized::LetterIndex_t common::CTriePoolOptimized::GetLetterAsIndex(const char letter)
-{
-  const auto result = letter - 'a';
-
-  assert(result < C_CHILDREN_COUNT);
-
-  return result;
-}
-
-
-inline char common::CTriePoolOptimized::GetIndexAsLetter(const LetterIndex_t letter)
-{
-  assert(letter < C_CHILDREN_COUNT);
-
-  const auto result = letter + 'a';
-
-  return result;
-}
-
-
-inline void common::CTriePoolOptimized::GetFoundWords
-(
-  const CTriePoolOptimized& currentTrie,
-  TContainerWriter<const char*>& wordList,
-  uint32_t& scoreOutput
-)
-{
-  if (currentTrie.m_found)
-  {
-    wordList.container[wordList.currentIndex++] = currentTrie.m_word;
-    scoreOutput += GetScoreForWordLength(strlen(currentTrie.m_word));
-  }
-
-  for (size_t i = 0; i < C_CHILDREN_COUNT; i++)
-  {
-    const Index_t childIndex = currentTrie.m_children[i];
-    if (!childIndex)
-    {
-      continue;
-    }
-
-    const CTriePoolOptimized* pChild = GetPtrFromIndex(childIndex);
-
-    GetFoundWords(*pChild, wordList, scoreOutput);
-  }
-}
-
-
-inline uint32_t common::CTriePoolOptimized::GetFoundWordsSize(const CTriePoolOptimized& currentTrie)
-{
-  uint32_t result = 0;
-
-  if (currentTrie.m_found)
-  {
-    result++;
-  }
-
-  for (size_t i = 0; i < C_CHILDREN_COUNT; i++)
-  {
-    const Index_t childIndex = currentTrie.m_children[i];
-    if (!childIndex)
-    {
-      continue;
-    }
-
-    const CTriePoolOptimized* pChild = GetPtrFromIndex(childIndex);
-
-#if defined(_DEBUG)
-    assert(currentTrie.m_debugChildren.at(i) == pChild);
-#endif
-
-    result += GetFoundWordsSize(*pChild);
-  }
-
-  return result;
-}
-
-
-inline uint32_t common::CTriePoolOptimized::GetScoreForWordLength(const size_t wordLength)
-{
-  static const uint8_t s_scoreTable[C_MAX_WORD_LENGTH + 1] =
-  {
-    0,
-    0,
-    0,
-    1,    //< 3
-    1,    //< 4
-    2,    //< 5
-    3,    //< 6
-    5,    //< 7
-    11,   //< 8
-    11,
-    11,
-    11,
-    11,
-    11,
-    11,
-    11,
-  };
-
-  assert(wordLength >= 3 && "This should be checked for while loading the dictionary.");
-  assert(wordLength < sizeof(s_scoreTable) && "This should be checked for while loading the dictionary.");
-
-  return s_scoreTable[wordLength];
-}
+#pragma once
+
+
+#include <common/containers/chunked-arena.hpp>
+#include <common/utils.hpp>
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(_DEBUG)
+  #include <iostream>
+#endif
+
+//TODO: Board should be in letter-format as well
+
+// ----------------------------------------------------------------------------
+
+
+namespace common
+{
+  class CTriePoolOptimizedRegion;
+  class CTriePoolOptimizedSearchContext;
+
+
+  /// Only the fields used while searching are kept in the trie itself. The
+  /// word text lives in a separate pool, referenced by word id, and the parent
+  /// links in an array next to the pool of tries. Both are only needed once a
+  /// word has been found.
+  class CTriePoolOptimized
+  {
+  public:
+
+    typedef uint8_t LetterIndex_t;
+    typedef uint32_t Index_t;
+    typedef uint32_t WordId_t;
+
+    static constexpr int32_t C_CHILDREN_COUNT = ('z' - 'a') + 1;
+    static const uint32_t C_MAX_WORD_LENGTH = common::C_MAX_WORD_LENGTH;
+
+    // ----------------------------------------------------------------------------
+
+
+    CTriePoolOptimized();
+    CTriePoolOptimized(const CTriePoolOptimized&) = delete;
+    CTriePoolOptimized(CTriePoolOptimized&&) = delete;
+    ~CTriePoolOptimized();
+
+    CTriePoolOptimized& operator = (const CTriePoolOptimized&) = delete;
+    CTriePoolOptimized& operator = (CTriePoolOptimized&&) = delete;
+
+    void AddWord(const std::string_view);
+
+    /// Same as above, but takes new tries from <region>. Several threads can
+    /// add words at once, as long as they use different regions and tries.
+    void AddWord(const std::string_view, CTriePoolOptimizedRegion& region);
+
+    /// Find the next Trie according to the letter index. The trie itself is
+    /// left untouched, and any found word is instead marked in the context.
+    Index_t FindTrieWithStartingLetter(const LetterIndex_t index, CTriePoolOptimizedSearchContext& context) const;
+
+    int32_t GetRemainingWords(const CTriePoolOptimizedSearchContext& context) const;
+
+    /// Child for the letter index, or 0. Unlike FindTrieWithStartingLetter,
+    /// nothing is marked as found.
+    Index_t GetChild(const LetterIndex_t index) const;
+
+    /// 0 if no word ends here
+    WordId_t GetWordId() const;
+
+    /// Bit n is set if there's a child for letter index n
+    uint32_t GetChildMask() const;
+
+    void DumpToScreen() const;
+
+    static void InitializePool();
+    static void ClearAllTries();
+
+    static Index_t AllocateTrie(Index_t parent = 0);
+
+    /// Reserve <count> consecutive tries without constructing them, and
+    /// return the index of the first. Safe to call from several threads.
+    static Index_t ReserveTries(const uint32_t count);
+
+    static CTriePoolOptimized* GetPtrFromIndex(Index_t index);
+    static CTriePoolOptimized::Index_t GetIndexFromPtr(const CTriePoolOptimized*);
+    static uint32_t GetAllocatedTrieCount();
+
+    static Index_t GetParent(const Index_t trie);
+
+    /// Text of a word, which is valid for as long as the pool is
+    static const char* GetWord(const WordId_t word);
+
+    /// How much of the pool is used, and how much memory it takes
+    static SArenaUsage GetPoolUsage();
+
+    /// Write every trie in the pool to <path> as a versioned and checksummed
+    /// image. <roots> are stored along with it, as they are needed again when
+    /// loading.
+    static bool SaveCompiledDictionary(const char* path, const std::vector<Index_t>& roots);
+
+    /// Replace the pool with the image at <path>. The image is mapped and used
+    /// as is, so nothing is parsed or constructed, but the tries are read-only.
+    static bool LoadCompiledDictionary(const char* path, std::vector<Index_t>& rootsOut);
+
+    static LetterIndex_t GetLetterAsIndex(const char letter);
+    static char GetIndexAsLetter(const LetterIndex_t letter);
+
+    static uint32_t GetScoreForWordLength(const size_t wordLength);
+
+  private:
+    friend class CTriePoolOptimizedRegion;
+
+    template <class TAllocateTrie>
+    void AddWordUsing(const std::string_view, TAllocateTrie&& allocateTrie);
+
+    static void SetParent(const Index_t trie, const Index_t parent);
+
+    /// Returns a new word id, and the buffer to store its text in
+    static WordId_t AllocateWord(char*& pTextOut);
+    static char* GetWordBuffer(const WordId_t word);
+
+  private:
+    /// Read for every trie visited, so these come first
+    int32_t m_wordCount;
+
+    /// 0 if no word ends here
+    WordId_t m_wordId;
+
+    uint32_t m_childMask;
+
+    std::array<Index_t, C_CHILDREN_COUNT> m_children;
+
+#if defined(_DEBUG)
+    std::array<CTriePoolOptimized*, C_CHILDREN_COUNT> m_debugChildren;
+    Index_t m_DebugMyId = 0;
+    static int32_t s_instanceCount;
+#endif
+  };
+
+
+  // ----------------------------------------------------------------------------
+
+
+  /// A block of tries reserved from the pool for one thread, so it can
+  /// allocate tries without any synchronization. Tries left unused when the
+  /// region is released are constructed as empty ones.
+  class CTriePoolOptimizedRegion
+  {
+  public:
+
+    typedef CTriePoolOptimized::Index_t Index_t;
+
+    CTriePoolOptimizedRegion() {}
+    CTriePoolOptimizedRegion(const CTriePoolOptimizedRegion&) = delete;
+    ~CTriePoolOptimizedRegion();
+
+    CTriePoolOptimizedRegion& operator = (const CTriePoolOptimizedRegion&) = delete;
+
+    Index_t AllocateTrie(const Index_t parent);
+    void Release();
+
+  private:
+    static const uint32_t C_RESERVE_COUNT = 128;
+
+    Index_t m_next = 0;
+    Index_t m_end = 0;
+  };
+
+
+  // ----------------------------------------------------------------------------
+
+
+  /// Holds the state of a single search, so that a loaded trie can be kept
+  /// immutable and serve any number of boards. Only the entries touched by a
+  /// search are cleared again, so a reset is O(words found).
+  class CTriePoolOptimizedSearchContext
+  {
+  public:
+
+    typedef CTriePoolOptimized::Index_t Index_t;
+
+    /// Must be called once the trie is complete, and before searching.
+    void Prepare(const uint32_t trieCount);
+    void Reset();
+
+    bool IsFound(const Index_t trie) const;
+
+    /// Words found anywhere below <trie>, not counting its own word
+    int32_t GetFoundWordCountBelow(const Index_t trie) const;
+    uint32_t GetFoundWordCount() const;
+
+    /// Returns false if the word was already found during this search. The
+    /// word is counted for <parent> and all of its own parents, so a trie with
+    /// all of its words found is known to be done right away.
+    bool MarkFound(const Index_t trie, const Index_t parent);
+
+    /// Tries of the words found, in the order they were found
+    const std::vector<Index_t>& GetFoundTries() const;
+
+  private:
+    std::vector<uint8_t> m_found;
+    std::vector<int32_t> m_foundWordCountBelow;
+
+    /// Tries marked as found, in the order of discovery. Used for the results
+    /// as well as for the reset.
+    std::vector<Index_t> m_foundTries;
+  };
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+inline common::CTriePoolOptimizedRegion::~CTriePoolOptimizedRegion()
+{
+  Release();
+}
+
+
+inline common::CTriePoolOptimizedRegion::Index_t common::CTriePoolOptimizedRegion::AllocateTrie(const Index_t parent)
+{
+  if (m_next == m_end)
+  {
+    Release();
+
+    m_next = CTriePoolOptimized::ReserveTries(C_RESERVE_COUNT);
+    m_end = m_next + C_RESERVE_COUNT;
+  }
+
+  const Index_t result = m_next++;
+
+  new (CTriePoolOptimized::GetPtrFromIndex(result)) CTriePoolOptimized();
+  CTriePoolOptimized::SetParent(result, parent);
+
+  return result;
+}
+
+
+inline void common::CTriePoolOptimizedRegion::Release()
+{
+  for (; m_next < m_end; m_next++)
+  {
+    new (CTriePoolOptimized::GetPtrFromIndex(m_next)) CTriePoolOptimized();
+    CTriePoolOptimized::SetParent(m_next, 0);
+  }
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+inline void common::CTriePoolOptimizedSearchContext::Prepare(const uint32_t trieCount)
+{
+  if (m_found.size() < trieCount)
+  {
+    m_found.resize(trieCount, 0);
+    m_foundWordCountBelow.resize(trieCount, 0);
+  }
+}
+
+
+inline void common::CTriePoolOptimizedSearchContext::Reset()
+{
+  for (const Index_t trie : m_foundTries)
+  {
+    m_found[trie] = 0;
+
+    for (Index_t parent = CTriePoolOptimized::GetParent(trie); parent && m_foundWordCountBelow[parent]; parent = CTriePoolOptimized::GetParent(parent))
+    {
+      m_foundWordCountBelow[parent] = 0;
+    }
+  }
+
+  m_foundTries.clear();
+}
+
+
+inline bool common::CTriePoolOptimizedSearchContext::IsFound(const Index_t trie) const
+{
+  assert(trie < m_found.size());
+
+  return m_found[trie] != 0;
+}
+
+
+inline int32_t common::CTriePoolOptimizedSearchContext::GetFoundWordCountBelow(const Index_t trie) const
+{
+  assert(trie < m_foundWordCountBelow.size());
+
+  return m_foundWordCountBelow[trie];
+}
+
+
+inline uint32_t common::CTriePoolOptimizedSearchContext::GetFoundWordCount() const
+{
+  return static_cast<uint32_t>(m_foundTries.size());
+}
+
+
+inline bool common::CTriePoolOptimizedSearchContext::MarkFound(const Index_t trie, const Index_t parent)
+{
+  assert(trie < m_found.size());
+
+  if (m_found[trie])
+  {
+    return false;
+  }
+
+  m_found[trie] = 1;
+  m_foundTries.push_back(trie);
+
+  for (Index_t currentParent = parent; currentParent; currentParent = CTriePoolOptimized::GetParent(currentParent))
+  {
+    m_foundWordCountBelow[currentParent]++;
+  }
+
+  return true;
+}
+
+
+inline const std::vector<common::CTriePoolOptimizedSearchContext::Index_t>& common::CTriePoolOptimizedSearchContext::GetFoundTries() const
+{
+  return m_foundTries;
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+inline common::CTriePoolOptimized::CTriePoolOptimized()
+  : m_wordCount(0)
+  , m_wordId(0)
+  , m_childMask(0)
+{
+  m_children.fill(0);
+
+#if defined(_DEBUG)
+  m_debugChildren.fill(nullptr);
+  m_DebugMyId = GetIndexFromPtr(this);
+  s_instanceCount++;
+#endif
+}
+
+
+inline common::CTriePoolOptimized::~CTriePoolOptimized()
+{
+#if defined(_DEBUG)
+  s_instanceCount--;
+#endif
+}
+
+
+inline void common::CTriePoolOptimized::AddWord(const std::string_view word)
+{
+  AddWordUsing(word, [](const Index_t parent) { return AllocateTrie(parent); });
+}
+
+
+inline void common::CTriePoolOptimized::AddWord(const std::string_view word, CTriePoolOptimizedRegion& region)
+{
+  AddWordUsing(word, [&region](const Index_t parent) { return region.AllocateTrie(parent); });
+}
+
+
+template <class TAllocateTrie>
+inline void common::CTriePoolOptimized::AddWordUsing(const std::string_view word, TAllocateTrie&& allocateTrie)
+{
+  CTriePoolOptimized* pCurrentTrie = this;
+  Index_t currentAsIndex = GetIndexFromPtr(pCurrentTrie);
+
+  assert(GetPtrFromIndex(currentAsIndex) == pCurrentTrie);
+
+  for (size_t i = 0; i < word.length(); i++)
+  {
+    const char currentLetter = word[i];
+    const auto currentIndex = GetLetterAsIndex(currentLetter);
+
+    if (currentLetter == 'q' && i + 1 < word.length() && word[i + 1] == 'u')
+    {
+      i++;
+    }
+
+    pCurrentTrie->m_wordCount++;
+
+    const Index_t childIndex = pCurrentTrie->m_children[currentIndex];
+    if (childIndex)
+    {
+      CTriePoolOptimized* pChildTrie = GetPtrFromIndex(childIndex);
+
+      assert(pChildTrie != pCurrentTrie);
+
+#if defined(_DEBUG)
+      assert(pChildTrie == pCurrentTrie->m_debugChildren.at(currentIndex));
+#endif
+
+      pCurrentTrie = pChildTrie;
+      currentAsIndex = childIndex;
+    }
+    else
+    {
+      const Index_t newChildIndex = allocateTrie(currentAsIndex);
+
+      pCurrentTrie->m_children[currentIndex] = newChildIndex;
+      pCurrentTrie->m_childMask |= 1u << currentIndex;
+
+#if defined(_DEBUG)
+      pCurrentTrie->m_debugChildren.at(currentIndex) = GetPtrFromIndex(newChildIndex);
+#endif
+
+      /// Next trie in the word-chain ...
+      pCurrentTrie = GetPtrFromIndex(newChildIndex);
+      currentAsIndex = newChildIndex;
+    }
+  }
+
+  ///
+  /// Add the actual word to the end trie. Words sharing a path (like "qintar"
+  /// and "quintar") share the id as well, and the last one added is kept.
+  ///
+  char* pText = nullptr;
+
+  if (pCurrentTrie->m_wordId)
+  {
+    pText = GetWordBuffer(pCurrentTrie->m_wordId);
+
+    /// It's still only one word to find, so don't count it twice
+    for (Index_t parent = GetParent(currentAsIndex); parent; parent = GetParent(parent))
+    {
+      GetPtrFromIndex(parent)->m_wordCount--;
+    }
+  }
+  else
+  {
+    pCurrentTrie->m_wordId = AllocateWord(pText);
+  }
+
+  assert(word.length() <= C_MAX_WORD_LENGTH);
+  memset(pText, 0, C_MAX_WORD_LENGTH + 1);
+  memcpy(pText, word.data(), word.length());
+}
+
+
+inline common::CTriePoolOptimized::Index_t common::CTriePoolOptimized::FindTrieWithStartingLetter(const LetterIndex_t index, CTriePoolOptimizedSearchContext& context) const
+{
+  assert(index < C_CHILDREN_COUNT);
+
+  const Index_t childIndex = m_children[index];
+  if (!childIndex)
+  {
+    return 0;
+  }
+
+  const CTriePoolOptimized* pCurrentTrie = GetPtrFromIndex(childIndex);
+
+  if (pCurrentTrie->m_wordId)
+  {
+    const Index_t parentIndex = GetIndexFromPtr(this);
+
+    assert(GetParent(childIndex) == parentIndex);
+
+    context.MarkFound(childIndex, parentIndex);
+
+    assert(context.GetFoundWordCountBelow(parentIndex) <= m_wordCount);
+  }
+
+  return childIndex;
+}
+
+
+inline common::CTriePoolOptimized::Index_t common::CTriePoolOptimized::GetChild(const LetterIndex_t index) const
+{
+  assert(index < C_CHILDREN_COUNT);
+
+  return m_children[index];
+}
+
+
+inline int32_t common::CTriePoolOptimized::GetRemainingWords(const CTriePoolOptimizedSearchContext& context) const
+{
+  return m_wordCount - context.GetFoundWordCountBelow(GetIndexFromPtr(this));
+}
+
+
+inline common::CTriePoolOptimized::WordId_t common::CTriePoolOptimized::GetWordId() const
+{
+  return m_wordId;
+}
+
+
+inline uint32_t common::CTriePoolOptimized::GetChildMask() const
+{
+  return m_childMask;
+}
+
+
+inline void common::CTriePoolOptimized::DumpToScreen() const
+{
+#if defined(_DEBUG)
+  std::cout << "Trie stats:" << std::endl;
+  std::cout << "\tWord count: " << m_wordCount << std::endl;
+
+  for (LetterIndex_t i = 0; i < C_CHILDREN_COUNT; i++)
+  {
+    if (!m_children[i])
+    {
+      continue;
+    }
+
+    //std::cout << "\tLetter " << int32_t(i) << " is " << GetIndexAsLetter(i) << " has word count: " << m_children[i]->m_wordCount << std::endl;
+  }
+
+#endif
+}
+
+
+inline common::CTriePoolOptimized::LetterIndex_t common::CTriePoolOptimized::GetLetterAsIndex(const char letter)
+{
+  const auto result = letter - 'a';
+
+  assert(result < C_CHILDREN_COUNT);
+
+  return result;
+}
+
+
+inline char common::CTriePoolOptimized::GetIndexAsLetter(const LetterIndex_t letter)
+{
+  assert(letter < C_CHILDREN_COUNT);
+
+  const auto result = letter + 'a';
+
+  return result;
+}
+
+
+inline uint32_t common::CTriePoolOptimized::GetScoreForWordLength(const size_t wordLength)
+{
+  return common::GetScoreForWordLength(wordLength);
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+
+///
+/// Zero-copy reader for dictionary files with one word per line
+///
+
+// ----------------------------------------------------------------------------
+
+
+#include "mapped-file.hpp"
+
+#include <common/utils.hpp>
+
+#include <cctype>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define ROTA_USE_SSE2 1
+#endif
+
+
+// ----------------------------------------------------------------------------
+
+
+namespace common
+{
+  /// Find the next '\n' in the range, or <pEnd> if there is none.
+  const char* FindNewLine(const char* pBegin, const char* pEnd);
+
+
+  /// Find where the first line at or after <offset> begins, or <pEnd>.
+  const char* FindLineStart(const char* pBegin, const char* pEnd, const size_t offset);
+
+
+  /// Call <callback> with every line in the range as a std::string_view. A
+  /// trailing non-letter (like the '\r' of a Windows line ending) is trimmed,
+  /// and lines outside the length range are skipped. Nothing is allocated.
+  template <class TCallback>
+  void ForEachDictionaryWord(const char* pBegin, const char* pEnd, const size_t minLength, const size_t maxLength, TCallback&& callback);
+
+
+  /// Map the file at <path> and go through all of it as above. The views are
+  /// only valid during the callback. Returns false if the file couldn't be
+  /// opened.
+  template <class TCallback>
+  bool ForEachDictionaryWord(const char* path, const size_t minLength, const size_t maxLength, TCallback&& callback);
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+inline const char* common::FindNewLine(const char* pBegin, const char* pEnd)
+{
+  const char* pCurrent = pBegin;
+
+#if defined(ROTA_USE_SSE2)
+  const __m128i newLines = _mm_set1_epi8('\n');
+
+  while (pEnd - pCurrent >= 16)
+  {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pCurrent));
+    const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newLines)));
+
+    if (mask)
+    {
+      return pCurrent + CountTrailingZeros(mask);
+    }
+
+    pCurrent += 16;
+  }
+#endif
+
+  /// The remaining tail, or everything if we have no SIMD
+  const void* pFound = memchr(pCurrent, '\n', size_t(pEnd - pCurrent));
+
+  return pFound ? static_cast<const char*>(pFound) : pEnd;
+}
+
+
+inline const char* common::FindLineStart(const char* pBegin, const char* pEnd, const size_t offset)
+{
+  if (offset == 0)
+  {
+    return pBegin;
+  }
+
+  if (offset >= size_t(pEnd - pBegin))
+  {
+    return pEnd;
+  }
+
+  /// A line starts right after a new line, which may be the one just before
+  /// <offset> itself.
+  const char* pNewLine = FindNewLine(pBegin + offset - 1, pEnd);
+
+  return pNewLine == pEnd ? pEnd : pNewLine + 1;
+}
+
+
+template <class TCallback>
+void common::ForEachDictionaryWord(const char* pBegin, const char* pEnd, const size_t minLength, const size_t maxLength, TCallback&& callback)
+{
+  const char* pCurrent = pBegin;
+
+  while (pCurrent < pEnd)
+  {
+    const char* pLineEnd = FindNewLine(pCurrent, pEnd);
+
+    size_t length = size_t(pLineEnd - pCurrent);
+
+    if (length && !isalpha(static_cast<unsigned char>(pCurrent[length - 1])))
+    {
+      length--;
+    }
+
+    if (length >= minLength && length <= maxLength)
+    {
+      callback(std::string_view(pCurrent, length));
+    }
+
+    pCurrent = pLineEnd + 1;
+  }
+}
+
+
+template <class TCallback>
+bool common::ForEachDictionaryWord(const char* path, const size_t minLength, const size_t maxLength, TCallback&& callback)
+{
+  CMappedFile file;
+  if (!file.Open(path))
+  {
+    return false;
+  }
+
+  ForEachDictionaryWord(file.GetData(), file.GetData() + file.GetSize(), minLength, maxLength, callback);
+
+  return true;
+}
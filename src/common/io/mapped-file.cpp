@@ -0,0 +1,150 @@
+#include "mapped-file.hpp"
+
+#ifdef _MSC_VER
+  #define WIN32_LEAN_AND_MEAN
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+
+// ----------------------------------------------------------------------------
+
+
+common::CMappedFile::~CMappedFile()
+{
+  Close();
+}
+
+
+#ifdef _MSC_VER
+
+bool common::CMappedFile::Open(const char* path, const EAccess access)
+{
+  Close();
+
+  HANDLE fileHandle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+    (access == EAccess::Sequential) ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS, nullptr);
+  if (fileHandle == INVALID_HANDLE_VALUE)
+  {
+    return false;
+  }
+
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(fileHandle, &fileSize))
+  {
+    CloseHandle(fileHandle);
+    return false;
+  }
+
+  m_fileHandle = fileHandle;
+
+  /// A mapping of 0 bytes isn't allowed, but an empty file is still valid
+  if (fileSize.QuadPart == 0)
+  {
+    return true;
+  }
+
+  m_mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!m_mappingHandle)
+  {
+    Close();
+    return false;
+  }
+
+  m_pData = static_cast<const char*>(MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+  if (!m_pData)
+  {
+    Close();
+    return false;
+  }
+
+  m_size = static_cast<size_t>(fileSize.QuadPart);
+
+  return true;
+}
+
+
+void common::CMappedFile::Close()
+{
+  if (m_pData)
+  {
+    UnmapViewOfFile(m_pData);
+  }
+
+  if (m_mappingHandle)
+  {
+    CloseHandle(m_mappingHandle);
+  }
+
+  if (m_fileHandle)
+  {
+    CloseHandle(m_fileHandle);
+  }
+
+  m_pData = nullptr;
+  m_size = 0;
+  m_mappingHandle = nullptr;
+  m_fileHandle = nullptr;
+}
+
+#else
+
+bool common::CMappedFile::Open(const char* path, const EAccess access)
+{
+  Close();
+
+  const int fileDescriptor = open(path, O_RDONLY);
+  if (fileDescriptor < 0)
+  {
+    return false;
+  }
+
+  struct stat fileStat;
+  if (fstat(fileDescriptor, &fileStat) != 0)
+  {
+    close(fileDescriptor);
+    return false;
+  }
+
+  /// A mapping of 0 bytes isn't allowed, but an empty file is still valid
+  if (fileStat.st_size == 0)
+  {
+    close(fileDescriptor);
+    return true;
+  }
+
+  void* pData = mmap(nullptr, size_t(fileStat.st_size), PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+
+  /// The mapping keeps its own reference to the file
+  close(fileDescriptor);
+
+  if (pData == MAP_FAILED)
+  {
+    return false;
+  }
+
+  madvise(pData, size_t(fileStat.st_size), (access == EAccess::Sequential) ? MADV_SEQUENTIAL : MADV_WILLNEED);
+
+  m_pData = static_cast<const char*>(pData);
+  m_size = size_t(fileStat.st_size);
+
+  return true;
+}
+
+
+void common::CMappedFile::Close()
+{
+  if (m_pData)
+  {
+    munmap(const_cast<char*>(m_pData), m_size);
+  }
+
+  m_pData = nullptr;
+  m_size = 0;
+}
+
+#endif
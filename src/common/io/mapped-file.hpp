@@ -0,0 +1,75 @@
+#pragma once
+
+
+///
+/// Read-only memory mapping of a whole file
+///
+
+// ----------------------------------------------------------------------------
+
+
+#include <cstddef>
+#include <cstdint>
+
+
+// ----------------------------------------------------------------------------
+
+
+namespace common
+{
+  class CMappedFile
+  {
+  public:
+
+    CMappedFile() {}
+    CMappedFile(const CMappedFile&) = delete;
+    CMappedFile(CMappedFile&&) = delete;
+    ~CMappedFile();
+
+    CMappedFile& operator = (const CMappedFile&) = delete;
+    CMappedFile& operator = (CMappedFile&&) = delete;
+
+    /// How the mapping is going to be read, which decides the read ahead
+    enum class EAccess
+    {
+      /// From one end to the other, once. Pages behind the read can go.
+      Sequential,
+
+      /// In any order and over and over, like the tries of a compiled
+      /// dictionary. The whole file is read in ahead of time instead.
+      Random,
+    };
+
+    /// Map the entire file at <path>. Returns false if the file couldn't be
+    /// opened or mapped. An empty file is valid, and gives a size of 0.
+    bool Open(const char* path, const EAccess access = EAccess::Sequential);
+    void Close();
+
+    const char* GetData() const;
+    size_t GetSize() const;
+
+  private:
+    const char* m_pData = nullptr;
+    size_t m_size = 0;
+
+#ifdef _MSC_VER
+    void* m_fileHandle = nullptr;
+    void* m_mappingHandle = nullptr;
+#endif
+  };
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+inline const char* common::CMappedFile::GetData() const
+{
+  return m_pData;
+}
+
+
+inline size_t common::CMappedFile::GetSize() const
+{
+  return m_size;
+}
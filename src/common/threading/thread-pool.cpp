@@ -0,0 +1,119 @@
+#include "thread-pool.hpp"
+
+#include <cassert>
+
+#if defined(_MSC_VER)
+  #include <windows.h>
+#elif defined(__linux__)
+  #include <pthread.h>
+  #include <sched.h>
+#endif
+
+
+// ----------------------------------------------------------------------------
+
+
+void common::CThreadPool::Start(const uint32_t threadCount, const std::vector<uint32_t>& cpuAffinity)
+{
+  Stop();
+
+  m_stopping = false;
+  m_threads.reserve(threadCount);
+
+  for (uint32_t i = 0; i < threadCount; i++)
+  {
+    m_threads.emplace_back([this, i, cpuAffinity]()
+    {
+      if (!cpuAffinity.empty())
+      {
+        SetCurrentThreadAffinity(cpuAffinity[i % cpuAffinity.size()]);
+      }
+
+      OnThread();
+    });
+  }
+}
+
+
+void common::CThreadPool::Stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopping = true;
+  }
+
+  m_wakeUp.notify_all();
+
+  for (std::thread& thread : m_threads)
+  {
+    thread.join();
+  }
+
+  m_threads.clear();
+
+  assert(m_tasks.empty());
+}
+
+
+void common::CThreadPool::Enqueue(std::function<void()> task)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_tasks.push_back(std::move(task));
+  }
+
+  m_wakeUp.notify_one();
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void common::CThreadPool::OnThread()
+{
+  for (;;)
+  {
+    std::function<void()> task;
+
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_wakeUp.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+
+      /// Queued work is always finished before stopping
+      if (m_tasks.empty())
+      {
+        return;
+      }
+
+      task = std::move(m_tasks.front());
+      m_tasks.pop_front();
+    }
+
+    task();
+  }
+}
+
+
+void common::CThreadPool::SetCurrentThreadAffinity(const uint32_t cpu)
+{
+#if defined(_MSC_VER)
+  if (cpu < sizeof(DWORD_PTR) * 8)
+  {
+    SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu);
+  }
+#elif defined(__linux__)
+  if (cpu >= CPU_SETSIZE)
+  {
+    return;
+  }
+
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  CPU_SET(cpu, &cpuSet);
+
+  /// Just a hint, so a CPU that isn't available is silently ignored
+  pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+#else
+  (void)cpu;
+#endif
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+
+///
+/// Long lived worker threads, which sleep until there is work for them
+///
+
+// ----------------------------------------------------------------------------
+
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// ----------------------------------------------------------------------------
+
+
+namespace common
+{
+  /// Threads are started once and then parked on a condition variable, so
+  /// handing them work costs a wake up rather than a thread creation. Work is
+  /// taken from a single FIFO queue.
+  class CThreadPool
+  {
+  public:
+
+    CThreadPool() {}
+    CThreadPool(const CThreadPool&) = delete;
+    ~CThreadPool();
+
+    CThreadPool& operator = (const CThreadPool&) = delete;
+
+    /// Start <threadCount> threads. If <cpuAffinity> isn't empty, thread N is
+    /// pinned to the CPU cpuAffinity[N % size]. Any running threads are
+    /// stopped first.
+    void Start(const uint32_t threadCount, const std::vector<uint32_t>& cpuAffinity);
+
+    /// Finish all queued work, and join the threads
+    void Stop();
+
+    uint32_t GetThreadCount() const;
+
+    void Enqueue(std::function<void()> task);
+
+    /// Call <function> once for every index in [0, count), and wait for all of
+    /// them to finish. The calling thread takes part as well, so this works
+    /// even without any threads in the pool.
+    template <class TFunction>
+    void RunForEachIndex(const size_t count, TFunction&& function);
+
+  private:
+    void OnThread();
+
+    static void SetCurrentThreadAffinity(const uint32_t cpu);
+
+  private:
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wakeUp;
+    std::deque<std::function<void()>> m_tasks;
+    bool m_stopping = false;
+  };
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+inline common::CThreadPool::~CThreadPool()
+{
+  Stop();
+}
+
+
+inline uint32_t common::CThreadPool::GetThreadCount() const
+{
+  return static_cast<uint32_t>(m_threads.size());
+}
+
+
+template <class TFunction>
+inline void common::CThreadPool::RunForEachIndex(const size_t count, TFunction&& function)
+{
+  ///
+  /// Indices are claimed one by one, by the caller and by as many helpers as
+  /// could possibly be of use. Which thread runs an index doesn't matter.
+  ///
+  std::atomic<size_t> nextIndex(0);
+
+  const auto runIndices = [&]()
+  {
+    for (size_t i = nextIndex++; i < count; i = nextIndex++)
+    {
+      function(i);
+    }
+  };
+
+  size_t helperCount = (count > 0) ? count - 1 : 0;
+  if (helperCount > m_threads.size())
+  {
+    helperCount = m_threads.size();
+  }
+
+  std::mutex doneMutex;
+  std::condition_variable done;
+  size_t remainingHelpers = helperCount;
+
+  for (size_t i = 0; i < helperCount; i++)
+  {
+    Enqueue([&]()
+    {
+      runIndices();
+
+      /// Notify while holding the lock, as the waiting caller owns all of
+      /// this state and returns as soon as it sees the count reach zero.
+      std::lock_guard<std::mutex> lock(doneMutex);
+      if (--remainingHelpers == 0)
+      {
+        done.notify_all();
+      }
+    });
+  }
+
+  runIndices();
+
+  std::unique_lock<std::mutex> lock(doneMutex);
+  done.wait(lock, [&]() { return remainingHelpers == 0; });
+}
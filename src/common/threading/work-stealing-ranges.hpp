@@ -0,0 +1,177 @@
+#pragma once
+
+
+///
+/// Items split between several owners, where idle owners steal from the busy
+///
+
+// ----------------------------------------------------------------------------
+
+
+#include <common/utils.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+
+
+// ----------------------------------------------------------------------------
+
+
+namespace common
+{
+  /// The items [0, count) start out evenly split into one consecutive range
+  /// per owner. Owners take items from the front of their own range, and once
+  /// it's empty they steal the back half of somebody else's. A range is a
+  /// single 64 bit value, so both only take a compare-and-swap.
+  ///
+  /// Consecutive items stay with one owner for as long as possible, which is
+  /// good for locality when neighbouring items share data.
+  class CWorkStealingRanges
+  {
+  public:
+
+    CWorkStealingRanges() {}
+    CWorkStealingRanges(const CWorkStealingRanges&) = delete;
+    CWorkStealingRanges& operator = (const CWorkStealingRanges&) = delete;
+
+    /// Not safe to call while any owner is taking items
+    void Initialize(const uint32_t ownerCount, const uint32_t itemCount);
+
+    /// Take the next item for <owner>, stealing one if its own range is empty.
+    /// Returns false once no owner has any items left.
+    bool Pop(const uint32_t owner, uint32_t& itemOut);
+
+  private:
+    bool PopOwn(const uint32_t owner, uint32_t& itemOut);
+    bool Steal(const uint32_t thief, uint32_t& itemOut);
+
+    static uint64_t MakeRange(const uint32_t begin, const uint32_t end);
+    static uint32_t GetBegin(const uint64_t range);
+    static uint32_t GetEnd(const uint64_t range);
+
+  private:
+    /// One per cache line, as the owners keep updating their own
+    struct alignas(C_CACHE_SIZE) SRange
+    {
+      std::atomic<uint64_t> range;
+    };
+
+    std::unique_ptr<SRange[]> m_ranges;
+    uint32_t m_ownerCount = 0;
+  };
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+inline void common::CWorkStealingRanges::Initialize(const uint32_t ownerCount, const uint32_t itemCount)
+{
+  assert(ownerCount > 0);
+
+  if (m_ownerCount != ownerCount)
+  {
+    m_ranges.reset(new SRange[ownerCount]);
+    m_ownerCount = ownerCount;
+  }
+
+  for (uint32_t i = 0; i < ownerCount; i++)
+  {
+    const uint32_t begin = static_cast<uint32_t>((uint64_t(itemCount) * i) / ownerCount);
+    const uint32_t end = static_cast<uint32_t>((uint64_t(itemCount) * (i + 1)) / ownerCount);
+
+    m_ranges[i].range.store(MakeRange(begin, end), std::memory_order_relaxed);
+  }
+}
+
+
+inline bool common::CWorkStealingRanges::Pop(const uint32_t owner, uint32_t& itemOut)
+{
+  assert(owner < m_ownerCount);
+
+  return PopOwn(owner, itemOut) || Steal(owner, itemOut);
+}
+
+
+inline bool common::CWorkStealingRanges::PopOwn(const uint32_t owner, uint32_t& itemOut)
+{
+  std::atomic<uint64_t>& ownRange = m_ranges[owner].range;
+
+  uint64_t range = ownRange.load(std::memory_order_relaxed);
+
+  for (;;)
+  {
+    const uint32_t begin = GetBegin(range);
+    const uint32_t end = GetEnd(range);
+
+    if (begin >= end)
+    {
+      return false;
+    }
+
+    if (ownRange.compare_exchange_weak(range, MakeRange(begin + 1, end), std::memory_order_relaxed))
+    {
+      itemOut = begin;
+      return true;
+    }
+  }
+}
+
+
+inline bool common::CWorkStealingRanges::Steal(const uint32_t thief, uint32_t& itemOut)
+{
+  for (uint32_t i = 1; i < m_ownerCount; i++)
+  {
+    std::atomic<uint64_t>& victimRange = m_ranges[(thief + i) % m_ownerCount].range;
+
+    uint64_t range = victimRange.load(std::memory_order_relaxed);
+
+    for (;;)
+    {
+      const uint32_t begin = GetBegin(range);
+      const uint32_t end = GetEnd(range);
+
+      if (begin >= end)
+      {
+        break;
+      }
+
+      /// The victim keeps the front half, which it is working its way through
+      const uint32_t middle = begin + ((end - begin) / 2);
+
+      if (victimRange.compare_exchange_weak(range, MakeRange(begin, middle), std::memory_order_relaxed))
+      {
+        ///
+        /// Nobody steals from an empty range, so there's no race on our own
+        /// range here.
+        ///
+        m_ranges[thief].range.store(MakeRange(middle + 1, end), std::memory_order_relaxed);
+
+        itemOut = middle;
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+
+inline uint64_t common::CWorkStealingRanges::MakeRange(const uint32_t begin, const uint32_t end)
+{
+  return (uint64_t(begin) << 32) | end;
+}
+
+
+inline uint32_t common::CWorkStealingRanges::GetBegin(const uint64_t range)
+{
+  return static_cast<uint32_t>(range >> 32);
+}
+
+
+inline uint32_t common::CWorkStealingRanges::GetEnd(const uint64_t range)
+{
+  return static_cast<uint32_t>(range);
+}
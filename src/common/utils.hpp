@@ -1,86 +1,175 @@
-#pragma once
-
-
-#ifdef _MSC_VER
-  #include <intrin.h>
-#else
-  #include <csignal>
-#endif
-
-#include <cstddef>
-#include <cstdint>
-
-
-// ----------------------------------------------------------------------------
-
-
-namespace common
-{
-  template <class T>
-  struct TContainerWriter
-  {
-    T* container;
-    uint32_t currentIndex = 0;
-  };
-
-
-  /// Like MS "_countof"
-  template <class T, size_t N>
-  constexpr size_t GetArrayLength(T const (&)[N])
-  {
-    return N;
-  }
-
-
-  template <typename T>
-  constexpr T AlignUpTo(T p, const size_t alignment)
-  {
-    return (p + (int64_t(alignment) - 1)) & -int64_t(alignment);
-  }
-
-
-  template <typename T>
-  constexpr T* AlignUpToPtr(T* p, const size_t alignment)
-  {
-    return reinterpret_cast<T*>( (uintptr_t(p) + (int64_t(alignment) - 1)) & -int64_t(alignment) );
-  }
-
-
-  inline long InterlockedIncrement(volatile long* pInteger)
-  {
-#ifdef _MSC_VER
-    return _InterlockedIncrement(pInteger);
-#else
-    return __atomic_add_fetch(pInteger, 1, __ATOMIC_SEQ_CST);
-#endif
-  }
-
-
-  static const uint32_t C_CACHE_SIZE = 64;
-}
-
-
-// ----------------------------------------------------------------------------
-
-
-#ifdef _MSC_VER
-  #define ROTA_BREAK __debugbreak()
-#else
-  #define ROTA_BREAK raise(SIGTRAP)
-#endif
-
-
-// ----------------------------------------------------------------------------
-
-
-#define ROTA_ASSERT(__statement) \
-  if ( !(__statement) ) ROTA_BREAK;
-
-
-// ----------------------------------------------------------------------------
-
-
-//#pragma optimize("", off)
-
-
-// ----------------------------------------------------------------------------
+#pragma once
+
+
+#ifdef _MSC_VER
+  #include <intrin.h>
+#else
+  #include <csignal>
+#endif
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+
+// ----------------------------------------------------------------------------
+
+
+namespace common
+{
+  template <class T>
+  struct TContainerWriter
+  {
+    T* container;
+    uint32_t currentIndex = 0;
+  };
+
+
+  /// Like MS "_countof"
+  template <class T, size_t N>
+  constexpr size_t GetArrayLength(T const (&)[N])
+  {
+    return N;
+  }
+
+
+  template <typename T>
+  constexpr T AlignUpTo(T p, const size_t alignment)
+  {
+    return (p + (int64_t(alignment) - 1)) & -int64_t(alignment);
+  }
+
+
+  template <typename T>
+  constexpr T* AlignUpToPtr(T* p, const size_t alignment)
+  {
+    return reinterpret_cast<T*>( (uintptr_t(p) + (int64_t(alignment) - 1)) & -int64_t(alignment) );
+  }
+
+
+  inline long InterlockedIncrement(volatile long* pInteger)
+  {
+#ifdef _MSC_VER
+    return _InterlockedIncrement(pInteger);
+#else
+    return __atomic_add_fetch(pInteger, 1, __ATOMIC_SEQ_CST);
+#endif
+  }
+
+
+  /// Returns the new value
+  inline long InterlockedAdd(volatile long* pInteger, const long value)
+  {
+#ifdef _MSC_VER
+    return _InterlockedExchangeAdd(pInteger, value) + value;
+#else
+    return __atomic_add_fetch(pInteger, value, __ATOMIC_SEQ_CST);
+#endif
+  }
+
+
+  /// Index of the lowest set bit. <value> must not be 0.
+  inline uint32_t CountTrailingZeros(const uint32_t value)
+  {
+#ifdef _MSC_VER
+    unsigned long result;
+    _BitScanForward(&result, value);
+    return result;
+#else
+    return __builtin_ctz(value);
+#endif
+  }
+
+
+  inline uint32_t CountTrailingZeros(const uint64_t value)
+  {
+#ifdef _MSC_VER
+    unsigned long result;
+    _BitScanForward64(&result, value);
+    return result;
+#else
+    return __builtin_ctzll(value);
+#endif
+  }
+
+
+  inline uint32_t PopCount(uint32_t value)
+  {
+#if defined(_MSC_VER)
+    return __popcnt(value);
+#elif defined(__POPCNT__)
+    return __builtin_popcount(value);
+#else
+    /// Without the instruction GCC calls a library function instead, so do
+    /// the bit twiddling inline.
+    value = value - ((value >> 1) & 0x55555555u);
+    value = (value & 0x33333333u) + ((value >> 2) & 0x33333333u);
+    return (((value + (value >> 4)) & 0x0f0f0f0fu) * 0x01010101u) >> 24;
+#endif
+  }
+
+
+  static const uint32_t C_CACHE_SIZE = 64;
+
+
+  /// According to the rules a valid word must be 3 or more letters, and the
+  /// upper limit is our own, to keep the score table small
+  static const uint32_t C_MIN_WORD_LENGTH = 3;
+  static const uint32_t C_MAX_WORD_LENGTH = 15;
+
+
+  /// The one score table shared by all tries and runtimes
+  inline uint32_t GetScoreForWordLength(const size_t wordLength)
+  {
+    static const uint8_t s_scoreTable[C_MAX_WORD_LENGTH + 1] =
+    {
+      0,
+      0,
+      0,
+      1,    //< 3
+      1,    //< 4
+      2,    //< 5
+      3,    //< 6
+      5,    //< 7
+      11,   //< 8
+      11,
+      11,
+      11,
+      11,
+      11,
+      11,
+      11,
+    };
+
+    assert(wordLength >= C_MIN_WORD_LENGTH && "This should be checked for while loading the dictionary.");
+    assert(wordLength < sizeof(s_scoreTable) && "This should be checked for while loading the dictionary.");
+
+    return s_scoreTable[wordLength];
+  }
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+#ifdef _MSC_VER
+  #define ROTA_BREAK __debugbreak()
+#else
+  #define ROTA_BREAK raise(SIGTRAP)
+#endif
+
+
+// ----------------------------------------------------------------------------
+
+
+#define ROTA_ASSERT(__statement) \
+  if ( !(__statement) ) ROTA_BREAK;
+
+
+// ----------------------------------------------------------------------------
+
+
+//#pragma optimize("", off)
+
+
+// ----------------------------------------------------------------------------